@@ -0,0 +1,171 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ai/PathClusters.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+
+#include "graphics/Math.h"
+#include "physics/Anchors.h"
+
+const float PathClusters::CLUSTER_SIZE = 1000.f;
+const float PathClusters::CLUSTER_HEIGHT = 500.f;
+
+PathClusters::PathClusters(size_t map_size, const ANCHOR_DATA * map_data)
+	: anchorClusters(map_size) {
+	
+	// Assign anchors to grid cells
+	typedef boost::tuple<long, long, long> Cell;
+	typedef std::map<Cell, ClusterId> Cells;
+	Cells cells;
+	std::vector<size_t> counts;
+	for(size_t i = 0; i < map_size; i++) {
+		
+		const Vec3f & pos = map_data[i].pos;
+		Cell cell(long(std::floor(pos.x / CLUSTER_SIZE)), long(std::floor(pos.y / CLUSTER_HEIGHT)),
+		          long(std::floor(pos.z / CLUSTER_SIZE)));
+		
+		std::pair<Cells::iterator, bool> result = cells.insert(Cells::value_type(cell, clusters.size()));
+		if(result.second) {
+			clusters.push_back(Cluster());
+			clusters.back().center = Vec3f_ZERO;
+			counts.push_back(0);
+		}
+		
+		ClusterId id = result.first->second;
+		anchorClusters[i] = id;
+		clusters[id].center += pos;
+		counts[id]++;
+	}
+	
+	for(size_t i = 0; i < clusters.size(); i++) {
+		clusters[i].center /= float(counts[i]);
+	}
+	
+	// Link clusters that have linked anchors
+	for(size_t i = 0; i < map_size; i++) {
+		
+		Cluster & cluster = clusters[anchorClusters[i]];
+		
+		for(short j = 0; j < map_data[i].nblinked; j++) {
+			
+			NodeId other = map_data[i].linked[j];
+			ClusterId target = anchorClusters[other];
+			if(target == anchorClusters[i]) {
+				continue;
+			}
+			
+			float radius = std::min(map_data[i].radius, map_data[other].radius);
+			float height = std::max(map_data[i].height, map_data[other].height);
+			
+			std::vector<Link>::iterator link = cluster.links.begin();
+			for(; link != cluster.links.end(); ++link) {
+				if(link->target == target) {
+					break;
+				}
+			}
+			
+			if(link == cluster.links.end()) {
+				Link newLink;
+				newLink.target = target;
+				newLink.radius = radius;
+				newLink.height = height;
+				cluster.links.push_back(newLink);
+			} else {
+				link->radius = std::max(link->radius, radius);
+				link->height = std::min(link->height, height);
+			}
+		}
+	}
+	
+}
+
+bool PathClusters::findCorridor(NodeId from, NodeId to, float radius, float height,
+                                std::vector<bool> & corridor) const {
+	
+	ClusterId start = anchorClusters[from];
+	ClusterId goal = anchorClusters[to];
+	
+	// A* over the cluster graph, entries are (estimated total cost, cost so far, cluster)
+	typedef boost::tuple<float, float, ClusterId> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+	std::vector<float> distances(clusters.size(), std::numeric_limits<float>::max());
+	std::vector<ClusterId> parents(clusters.size(), ClusterId(-1));
+	
+	distances[start] = 0.f;
+	open.push(Entry(fdist(clusters[start].center, clusters[goal].center), 0.f, start));
+	
+	bool found = false;
+	while(!open.empty()) {
+		
+		ClusterId id = open.top().get<2>();
+		float cost = open.top().get<1>();
+		open.pop();
+		
+		if(id == goal) {
+			found = true;
+			break;
+		}
+		
+		const Cluster & cluster = clusters[id];
+		if(cost > distances[id]) {
+			continue; // Stale queue entry
+		}
+		
+		for(size_t i = 0; i < cluster.links.size(); i++) {
+			
+			const Link & link = cluster.links[i];
+			if(link.radius < radius || link.height > height) {
+				continue;
+			}
+			
+			const Cluster & next = clusters[link.target];
+			float distance = distances[id] + fdist(cluster.center, next.center);
+			if(distance < distances[link.target]) {
+				distances[link.target] = distance;
+				parents[link.target] = id;
+				float estimate = distance + fdist(next.center, clusters[goal].center);
+				open.push(Entry(estimate, distance, link.target));
+			}
+		}
+	}
+	
+	if(!found) {
+		return false;
+	}
+	
+	// Mark the clusters on the route and their neighbours
+	corridor.assign(clusters.size(), false);
+	for(ClusterId id = goal; id != ClusterId(-1); id = parents[id]) {
+		corridor[id] = true;
+		const Cluster & cluster = clusters[id];
+		for(size_t i = 0; i < cluster.links.size(); i++) {
+			corridor[cluster.links[i].target] = true;
+		}
+	}
+	
+	return true;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_AI_PATHCLUSTERS_H
+#define ARX_AI_PATHCLUSTERS_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "math/Types.h"
+
+struct ANCHOR_DATA;
+
+/*!
+ * Coarse graph on top of the anchor graph, used to restrict long path searches.
+ *
+ * Anchors are grouped into clusters on a regular 3D grid. Two clusters are linked
+ * if any anchor in one is linked to an anchor in the other.
+ * The graph only depends on the static anchor layout, so it is built once per level
+ * and can be shared between pathfinder threads.
+ */
+class PathClusters {
+	
+public:
+	
+	typedef unsigned long NodeId;
+	typedef unsigned long ClusterId;
+	
+	//! Horizontal size of the cluster grid cells
+	static const float CLUSTER_SIZE;
+	//! Vertical size of the cluster grid cells
+	static const float CLUSTER_HEIGHT;
+	
+	PathClusters(size_t map_size, const ANCHOR_DATA * map_data);
+	
+	size_t getClusterCount() const { return clusters.size(); }
+	
+	ClusterId getCluster(NodeId anchor) const { return anchorClusters[anchor]; }
+	
+	/*!
+	 * Find the clusters a path between two anchors should go through.
+	 * \param from The index of the start anchor.
+	 * \param to The index of the destination anchor.
+	 * \param radius The radius of the cylinder that needs to fit through the links.
+	 * \param height The height of the cylinder that needs to fit through the links.
+	 * \param corridor Set to true for every cluster on the route and for its neighbours.
+	 *                 Will be resized to the cluster count.
+	 * \return false if the two clusters are not connected.
+	 */
+	bool findCorridor(NodeId from, NodeId to, float radius, float height,
+	                  std::vector<bool> & corridor) const;
+	
+private:
+	
+	struct Link {
+		ClusterId target;
+		float radius; // Largest cylinder radius supported by any anchor link
+		float height; // Smallest cylinder height required by any anchor link
+	};
+	
+	struct Cluster {
+		Vec3f center;
+		std::vector<Link> links;
+	};
+	
+	std::vector<ClusterId> anchorClusters;
+	std::vector<Cluster> clusters;
+	
+};
+
+#endif // ARX_AI_PATHCLUSTERS_H
@@ -45,9 +45,11 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include <limits>
 #include <algorithm>
+#include <deque>
 
 #include <glm/gtx/norm.hpp>
 
+#include "ai/PathClusters.h"
 #include "graphics/GraphicsTypes.h"
 #include "graphics/Math.h"
 #include "graphics/data/Mesh.h"
@@ -59,6 +61,9 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 static const float MIN_RADIUS = 110.0f;
 
+// Searches shorter than this don't use the cluster graph.
+static const float CLUSTER_MIN_DISTANCE = 2.f * PathClusters::CLUSTER_SIZE;
+
 const float PathFinder::HEURISTIC_MIN = 0.0f;
 const float PathFinder::HEURISTIC_MAX = 0.5f;
 
@@ -74,10 +79,15 @@ class PathFinder::Node {
 	float cost;
 	float distance;
 	
+	size_t heapIndex;
+	
 public:
 	
+	static const size_t NotInHeap = size_t(-1);
+	
 	Node(long _id, const Node * _parent, float _distance, float _remaining)
-		: id(_id), parent(_parent), cost(_distance + _remaining), distance(_distance) { }
+		: id(_id), parent(_parent), cost(_distance + _remaining), distance(_distance),
+		  heapIndex(NotInHeap) { }
 	
 	inline NodeId getId() const {
 		return id;
@@ -101,21 +111,90 @@ public:
 		distance = _distance;
 	}
 	
+	inline size_t getHeapIndex() const {
+		return heapIndex;
+	}
+	
+	inline void setHeapIndex(size_t index) {
+		heapIndex = index;
+	}
+	
 };
 
-class PathFinder::OpenNodeList {
+/*!
+ * Storage for all nodes created during a single search.
+ * Nodes are never freed individually - they all live until the search is done.
+ * A deque is used so that node addresses stay stable as the arena grows.
+ */
+class PathFinder::NodeArena {
 	
-	typedef std::vector<Node*> NodeList;
-	NodeList nodes;
+	std::deque<Node> nodes;
 	
 public:
 	
-	~OpenNodeList() {
-		for(NodeList::iterator i = nodes.begin(); i != nodes.end(); ++i) {
-			delete *i;
+	Node * create(NodeId id, const Node * parent, float distance, float remaining) {
+		nodes.push_back(Node(id, parent, distance, remaining));
+		return &nodes.back();
+	}
+	
+};
+
+/*!
+ * Binary min-heap of open nodes, ordered by cost.
+ * Nodes are also indexed by their ID so that updating the cost of an
+ * already opened node (decrease-key) does not require a search.
+ */
+class PathFinder::OpenNodeList {
+	
+	typedef std::vector<Node *> NodeList;
+	
+	NodeArena & arena;
+	NodeList heap;
+	NodeList index; // Nodes by ID, NULL if the ID was never opened
+	
+	void place(size_t i, Node * node) {
+		heap[i] = node;
+		node->setHeapIndex(i);
+	}
+	
+	void siftUp(size_t i) {
+		Node * node = heap[i];
+		while(i > 0) {
+			size_t parent = (i - 1) / 2;
+			if(heap[parent]->getCost() <= node->getCost()) {
+				break;
+			}
+			place(i, heap[parent]);
+			i = parent;
+		}
+		place(i, node);
+	}
+	
+	void siftDown(size_t i) {
+		Node * node = heap[i];
+		size_t count = heap.size();
+		while(true) {
+			size_t child = 2 * i + 1;
+			if(child >= count) {
+				break;
+			}
+			if(child + 1 < count && heap[child + 1]->getCost() < heap[child]->getCost()) {
+				child++;
+			}
+			if(node->getCost() <= heap[child]->getCost()) {
+				break;
+			}
+			place(i, heap[child]);
+			i = child;
 		}
+		place(i, node);
 	}
 	
+public:
+	
+	OpenNodeList(NodeArena & _arena, size_t map_size)
+		: arena(_arena), index(map_size, NULL) { }
+	
 	/*!
 	 * If a node with the same ID exists, update it.
 	 * Otherwise add a new node.
@@ -124,36 +203,39 @@ public:
 	inline void add(NodeId id, const Node * parent, float distance, float remaining) {
 		
 		// Check if node is already in open list.
-		for(NodeList::iterator i = nodes.begin(); i != nodes.end(); ++i) {
-			if((*i)->getId() == id) {
-				if((*i)->getDistance() > distance) {
-					(*i)->newParent(parent, distance);
-				}
-				return;
+		Node * node = index[id];
+		if(node) {
+			if(node->getHeapIndex() != Node::NotInHeap && node->getDistance() > distance) {
+				node->newParent(parent, distance);
+				siftUp(node->getHeapIndex());
 			}
+			return;
 		}
 		
-		nodes.push_back(new Node(id, parent, distance, remaining));
+		node = arena.create(id, parent, distance, remaining);
+		index[id] = node;
+		heap.push_back(node);
+		siftUp(heap.size() - 1);
 	}
 	
+	/*!
+	 * \return the best node (lowest cost) from open list or NULL if the list is empty
+	 */
 	Node * extractBestNode() {
-		// TODO use a better datastructure
 		
-		if(nodes.empty()) {
+		if(heap.empty()) {
 			return NULL;
 		}
 		
-		NodeList::iterator best = nodes.begin();
-		float cost = std::numeric_limits<float>::max();
-		for(NodeList::iterator i = nodes.begin(); i != nodes.end(); ++i) {
-			if((*i)->getCost() < cost) {
-				cost = (*i)->getCost();
-				best = i;
-			}
-		}
+		Node * node = heap.front();
+		node->setHeapIndex(Node::NotInHeap);
 		
-		Node * node = *best;
-		nodes.erase(best);
+		Node * last = heap.back();
+		heap.pop_back();
+		if(!heap.empty()) {
+			place(0, last);
+			siftDown(0);
+		}
 		
 		return node;
 	}
@@ -162,29 +244,18 @@ public:
 
 class PathFinder::ClosedNodeList {
 	
-	typedef std::vector<Node*> NodeList;
-	NodeList nodes;
+	std::vector<bool> closed;
 	
 public:
 	
-	~ClosedNodeList() {
-		for(NodeList::iterator i = nodes.begin(); i != nodes.end(); ++i) {
-			delete *i;
-		}
-	}
+	explicit ClosedNodeList(size_t map_size) : closed(map_size, false) { }
 	
-	void add(Node * node) {
-		nodes.push_back(node);
+	void add(const Node * node) {
+		closed[node->getId()] = true;
 	}
 	
 	bool contains(NodeId id) const {
-		// TODO better datastructure: set of closed node ids
-		for(NodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i) {
-			if((*i)->getId() == id) {
-				return true;
-			}
-		}
-		return false;
+		return closed[id];
 	}
 	
 };
@@ -192,7 +263,8 @@ public:
 PathFinder::PathFinder(size_t map_size, const ANCHOR_DATA * map_data,
                        size_t slight_count, const EERIE_LIGHT * const * slight_list)
 	: radius(RADIUS_DEFAULT), height(HEIGHT_DEFAULT), heuristic(HEURISTIC_DEFAULT),
-	  map_s(map_size), map_d(map_data), slight_c(slight_count), slight_l(slight_list) { }
+	  map_s(map_size), map_d(map_data), slight_c(slight_count), slight_l(slight_list),
+	  clusters(NULL), lightGridBuilt(false) { }
 
 void PathFinder::setHeuristic(float _heuristic) {
 	if(_heuristic >= HEURISTIC_MAX) {
@@ -209,6 +281,14 @@ void PathFinder::setCylinder(float _radius, float _height) {
 	height = _height;
 }
 
+void PathFinder::setClusters(const PathClusters * _clusters) {
+	clusters = _clusters;
+}
+
+void PathFinder::invalidateLights() {
+	lightGridBuilt = false;
+}
+
 bool PathFinder::move(NodeId from, NodeId to, Result & rlist, bool stealth) const {
 	
 	if(from == to) {
@@ -216,15 +296,28 @@ bool PathFinder::move(NodeId from, NodeId to, Result & rlist, bool stealth) cons
 		return true;
 	}
 	
-	// Create start node and put it on open list
-	Node * node = new Node(from, NULL, 0.0f, 0.0f);
-	if(!node) {
-		return false;
+	if(clusters && clusters->getCluster(from) != clusters->getCluster(to)
+	   && !closerThan(map_d[from].pos, map_d[to].pos, CLUSTER_MIN_DISTANCE)) {
+		std::vector<bool> corridor;
+		if(clusters->findCorridor(from, to, radius, height, corridor)
+		   && search(from, to, rlist, stealth, &corridor)) {
+			return true;
+		}
 	}
 	
+	return search(from, to, rlist, stealth, NULL);
+}
+
+bool PathFinder::search(NodeId from, NodeId to, Result & rlist, bool stealth,
+                        const std::vector<bool> * corridor) const {
+	
+	// Create start node and put it on open list
+	NodeArena arena;
+	Node * node = arena.create(from, NULL, 0.0f, 0.0f);
+	
 	// A* main loop
-	OpenNodeList open;
-	ClosedNodeList close;
+	OpenNodeList open(arena, map_s);
+	ClosedNodeList close(map_s);
 	do {
 		
 		// Put node onto close list as we have now examined this node.
@@ -252,6 +345,10 @@ bool PathFinder::move(NodeId from, NodeId to, Result & rlist, bool stealth) cons
 				continue;
 			}
 			
+			if(corridor && !(*corridor)[clusters->getCluster(cid)]) {
+				continue;
+			}
+			
 			// Cost to reach this node.
 			float distance = fdist(map_d[cid].pos, map_d[nid].pos);
 			if(stealth) {
@@ -284,14 +381,12 @@ bool PathFinder::flee(NodeId from, const Vec3f & danger, float safeDist, Result
 	}
 	
 	// Create start node and put it on open list
-	Node * node = new Node(from, NULL, 0.0f, 0.0f);
-	if(!node) {
-		return false;
-	}
+	NodeArena arena;
+	Node * node = arena.create(from, NULL, 0.0f, 0.0f);
 	
 	// A* main loop
-	OpenNodeList open;
-	ClosedNodeList close;
+	OpenNodeList open(arena, map_s);
+	ClosedNodeList close(map_s);
 	do {
 		
 		// Put node onto close list as we have now examined this node.
@@ -469,7 +564,19 @@ float PathFinder::getIlluminationCost(const Vec3f & pos) const {
 	
 	float cost = 0.0f;
 	
-	for(size_t i = 0; i < slight_c; i++) {
+	if(!lightGridBuilt) {
+		lightGrid.build(slight_l, slight_c);
+		lightGridBuilt = true;
+	}
+	
+	float range = lightGrid.getMaxFalloff();
+	nearLights.clear();
+	lightGrid.query(Vec2f(pos.x - range, pos.z - range), Vec2f(pos.x + range, pos.z + range),
+	                nearLights);
+	
+	for(size_t j = 0; j < nearLights.size(); j++) {
+		
+		size_t i = nearLights[j];
 		
 		if(!slight_l[i] || !slight_l[i]->exist || !slight_l[i]->m_ignitionStatus) {
 			continue;
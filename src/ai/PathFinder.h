@@ -48,9 +48,10 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <vector>
 
 #include "math/Types.h"
+#include "scene/Light.h"
 
 struct ANCHOR_DATA;
-struct EERIE_LIGHT;
+class PathClusters;
 
 
 class PathFinder {
@@ -68,6 +69,7 @@ public:
 	 * Create a PathFinder instance for the provided data.
 	 * The pathfinder instance does not copy the provided data and will not clean it up
 	 * The light data is only used when the stealth parameter is set to true.
+	 * A PathFinder instance must not be used by more than one thread at a time.
 	 */
 	PathFinder(size_t map_size, const ANCHOR_DATA * map_data,
 	           size_t light_count, const EERIE_LIGHT * const * light_list);
@@ -90,6 +92,20 @@ public:
 	 */
 	void setCylinder(float radius, float height);
 	
+	/*!
+	 * Set a coarse cluster graph for the map data.
+	 * If set, long searches in move() first find a route through the clusters and
+	 * then only expand nodes near that route, falling back to a full search if that fails.
+	 * The pathfinder does not copy the cluster graph and will not clean it up.
+	 */
+	void setClusters(const PathClusters * clusters);
+	
+	/*!
+	 * Discard the index of the light data.
+	 * Must be called after lights in the light list have been added, removed or moved.
+	 */
+	void invalidateLights();
+	
 	/*!
 	 * Find a path between two nodes.
 	 * \param from The index of the start node into the provided map_data.
@@ -135,12 +151,12 @@ public:
 private:
 	
 	class Node;
+	class NodeArena;
 	class OpenNodeList;
 	class ClosedNodeList;
 	
-	/*!
-	 * \return the best node (lowest cost) from open list or NULL if the list is empty
-	 */
+	bool search(NodeId from, NodeId to, Result & rlist, bool stealth,
+	            const std::vector<bool> * corridor) const;
 	static void buildPath(const Node & node, Result & rlist);
 	float getIlluminationCost(const Vec3f & pos) const;
 	NodeId getNearestNode(const Vec3f & pos) const;
@@ -153,6 +169,13 @@ private:
 	const ANCHOR_DATA * map_d; // Map data
 	size_t slight_c; // Light count
 	const EERIE_LIGHT * const * slight_l; // Light data
+	const PathClusters * clusters;
+	
+	// Index of the light data, built on the first stealth search after the
+	// pathfinder is created or invalidateLights() is called.
+	mutable LightGrid lightGrid;
+	mutable bool lightGridBuilt;
+	mutable std::vector<size_t> nearLights;
 	
 };
 
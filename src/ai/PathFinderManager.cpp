@@ -49,15 +49,25 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <cstring>
 #include <cstdlib>
 #include <algorithm>
+#include <deque>
+#include <list>
+#include <vector>
 
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "ai/PathClusters.h"
 #include "ai/PathFinder.h"
 #include "game/Entity.h"
+#include "game/EntityManager.h"
 #include "game/NPC.h"
 #include "graphics/Math.h"
 #include "platform/Thread.h"
 #include "platform/Lock.h"
+#include "platform/Semaphore.h"
 #include "platform/profiler/Profiler.h"
 #include "physics/Anchors.h"
+#include "scene/Interactive.h"
 #include "scene/Light.h"
 
 static const float PATHFINDER_HEURISTIC_MIN = 0.2f;
@@ -67,177 +77,464 @@ static const float PATHFINDER_HEURISTIC_RANGE = PATHFINDER_HEURISTIC_MAX
 static const float PATHFINDER_DISTANCE_MAX = 5000.0f;
 
 // Pathfinder Definitions
-static unsigned long PATHFINDER_UPDATE_INTERVAL = 10;
+static const unsigned PATHFINDER_MAX_WORKERS = 4;
+static const size_t PATHFINDER_CACHE_SIZE = 256;
 
 long PATHFINDER_WORKING = 0;
 
+/*!
+ * A queued path search.
+ * Everything the search needs from the entity is copied when the request is queued
+ * so that the workers never touch entity data.
+ */
+struct PathFinderJob {
+	
+	EntityHandle handle;
+	unsigned long serial;
+	unsigned long lightVersion;
+	
+	long from;
+	long to;
+	
+	Behaviour behavior;
+	float behavior_param;
+	float radius;
+	float height;
+	Vec3f pos;
+	Vec3f target;
+	
+	PathFinder::Result result;
+	
+};
+
 class PathFinderThread : public StoppableThread {
 	
 	void run();
 	
 };
 
-static PathFinderThread * pathfinder = NULL;
+typedef std::vector<PathFinderThread *> Workers;
+static Workers workers;
+
+// Coarse anchor graph shared by all workers
+static PathClusters * clusters = NULL;
+
+// Protects the request and result queues - never held during a search.
 static Lock * mutex = NULL;
 
-struct PATHFINDER_QUEUE_ELEMENT {
-	PATHFINDER_REQUEST req;
-	PATHFINDER_QUEUE_ELEMENT * next;
-	long valid;
-};
+// Posted once for each new request, and once for each worker when releasing them.
+static Semaphore * wakeup = NULL;
+
+// Set when the workers are being released, protected by the mutex.
+static bool stopping = false;
 
-static PATHFINDER_QUEUE_ELEMENT * pathfinder_queue_start = NULL;
+static std::deque<PathFinderJob *> requests;
+static std::vector<PathFinderJob *> results;
 
-// An Io can request Pathfinding only once so we insure that it's always the case.
-// A new pathfinder request from the same IO will overwrite the precedent.
-static PATHFINDER_QUEUE_ELEMENT * PATHFINDER_Find_ioid(Entity * io) {
+// Serial of the latest request for each entity index, 0 if there is none.
+// Only accessed from the main thread.
+static std::vector<unsigned long> latestRequest;
+static unsigned long nextSerial = 0;
+
+/*!
+ * Key for cached move() results.
+ * Other searches depend on random numbers or on the target position and are not cached.
+ */
+struct PathCacheKey {
 	
-	if(!pathfinder_queue_start)
-		return NULL;
+	long from;
+	long to;
+	float radius;
+	float height;
+	bool stealth;
+	
+	bool operator==(const PathCacheKey & o) const {
+		return from == o.from && to == o.to && radius == o.radius && height == o.height
+		       && stealth == o.stealth;
+	}
+	
+};
 
-	PATHFINDER_QUEUE_ELEMENT * cur = pathfinder_queue_start;
+static size_t hash_value(const PathCacheKey & key) {
+	size_t seed = 0;
+	boost::hash_combine(seed, key.from);
+	boost::hash_combine(seed, key.to);
+	boost::hash_combine(seed, key.radius);
+	boost::hash_combine(seed, key.height);
+	boost::hash_combine(seed, key.stealth);
+	return seed;
+}
 
-	while(cur) {
-		if(cur->req.ioid == io)
-			return cur->valid ? cur : NULL;
+//! LRU cache of path results, protected by mutex
+class PathCache {
+	
+	typedef std::pair<PathCacheKey, PathFinder::Result> Entry;
+	typedef std::list<Entry> Entries;
+	typedef boost::unordered_map<PathCacheKey, Entries::iterator, boost::hash<PathCacheKey> > Index;
+	
+	Entries entries; // Most recently used first
+	Index index;
+	
+public:
+	
+	//! Incremented whenever the cache is invalidated
+	unsigned long generation;
+	
+	long hits;
+	long misses;
+	
+	PathCache() : generation(0), hits(0), misses(0) { }
+	
+	bool lookup(const PathCacheKey & key, PathFinder::Result & result) {
+		
+		Index::iterator it = index.find(key);
+		if(it == index.end()) {
+			misses++;
+			return false;
+		}
 		
-		cur = cur->next;
+		entries.splice(entries.begin(), entries, it->second);
+		result = it->second->second;
+		hits++;
+		return true;
 	}
+	
+	void store(const PathCacheKey & key, const PathFinder::Result & result) {
+		
+		Index::iterator it = index.find(key);
+		if(it != index.end()) {
+			entries.splice(entries.begin(), entries, it->second);
+			it->second->second = result;
+			return;
+		}
+		
+		if(entries.size() >= PATHFINDER_CACHE_SIZE) {
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+		
+		entries.push_front(Entry(key, result));
+		index[key] = entries.begin();
+	}
+	
+	void clear() {
+		entries.clear();
+		index.clear();
+		generation++;
+	}
+	
+};
 
-	return NULL;
-}
+static PathCache cache;
 
 // Adds a Pathfinder Search Element to the pathfinder queue.
 bool EERIE_PATHFINDER_Add_To_Queue(const PATHFINDER_REQUEST & req) {
 	
-	if(!pathfinder) {
+	if(workers.empty() || !req.ioid || !req.ioid->_npcdata) {
 		return false;
 	}
 	
+	Entity * io = req.ioid;
+	EntityHandle handle = io->index();
+	
+	unsigned long serial = ++nextSerial;
+	if(size_t(handle) >= latestRequest.size()) {
+		latestRequest.resize(size_t(handle) + 1, 0);
+	}
+	latestRequest[handle] = serial;
+	
 	Autolock lock(mutex);
-
-	PATHFINDER_QUEUE_ELEMENT * cur = pathfinder_queue_start;
-
-	PATHFINDER_QUEUE_ELEMENT * temp;
-
-	// If this NPC is already requesting a Pathfinding then either
-	// try to Override it or add it to queue if it is currently being
-	// processed.
-	temp = PATHFINDER_Find_ioid(req.ioid);
-
-	if(temp && temp->valid && temp != pathfinder_queue_start) {
-		temp->valid = 0;
-		temp->req = req;
-		temp->valid = 1;
-		return true;
+	
+	// An Io can request Pathfinding only once so we insure that it's always the case.
+	// A new pathfinder request from the same IO will overwrite the precedent.
+	PathFinderJob * job = NULL;
+	for(size_t i = 0; i < requests.size(); i++) {
+		if(requests[i]->handle == handle) {
+			job = requests[i];
+			break;
+		}
 	}
-
-	// Create a New element for the queue
-	temp = new PATHFINDER_QUEUE_ELEMENT;
-
-	if(!temp) {
-		return false;
+	
+	bool queued = (job != NULL);
+	if(!queued) {
+		job = new PathFinderJob;
+		job->handle = handle;
 	}
-
-	// Fill this New element with new request
-	temp->req = req;
-	temp->valid = 1;
-
-	// No queue start ? then this element becomes the queue start
-	if(!cur) {
-		temp->next = NULL;
-		pathfinder_queue_start = temp;
-		
-	} else if((req.ioid->_npcdata->behavior & (BEHAVIOUR_MOVE_TO | BEHAVIOUR_FLEE
-	                                            | BEHAVIOUR_LOOK_FOR)) && cur->next) {
-		// priority: insert as second element of queue
-		temp->next = cur->next;
-		cur->next = temp;
-		
+	
+	job->serial = serial;
+	job->from = req.from;
+	job->to = req.to;
+	job->behavior = io->_npcdata->behavior;
+	job->behavior_param = io->_npcdata->behavior_param;
+	job->radius = io->physics.cyl.radius;
+	job->height = io->physics.cyl.height;
+	job->pos = io->pos;
+	job->target = io->target;
+	job->lightVersion = EERIE_LIGHT_GetVersion();
+	
+	if(queued) {
+		return true;
+	}
+	
+	if(job->behavior & (BEHAVIOUR_MOVE_TO | BEHAVIOUR_FLEE | BEHAVIOUR_LOOK_FOR)) {
+		// priority: insert at the start of the queue
+		requests.push_front(job);
 	} else {
-		
-		// add to end of queue
-		temp->next = NULL;
-		
-		if(!pathfinder_queue_start) {
-			pathfinder_queue_start = temp;
-			return true;
-		} else {
-			while(cur->next) {
-				cur = cur->next;
-			}
-			cur->next = temp;
-		}
+		requests.push_back(job);
 	}
 	
+	wakeup->post();
+	
 	return true;
 }
 
 long EERIE_PATHFINDER_Get_Queued_Number() {
-	if(!mutex)
+	
+	if(!mutex) {
 		return 0;
-
+	}
+	
 	Autolock lock(mutex);
 	
-	PATHFINDER_QUEUE_ELEMENT * cur = pathfinder_queue_start;
+	return long(requests.size());
+}
 
-	long count = 0;
+static void EERIE_PATHFINDER_Clear_Private() {
+	
+	for(size_t i = 0; i < requests.size(); i++) {
+		delete requests[i];
+	}
+	requests.clear();
+	
+	for(size_t i = 0; i < results.size(); i++) {
+		delete results[i];
+	}
+	results.clear();
+	
+}
 
-	while (cur) cur = cur->next, count++;
+void EERIE_PATHFINDER_Invalidate_Cache() {
+	
+	if(!mutex) {
+		return;
+	}
+	
+	Autolock lock(mutex);
+	
+	cache.clear();
+}
 
-	return count;
+void EERIE_PATHFINDER_Get_Cache_Stats(long & hits, long & misses) {
+	
+	if(!mutex) {
+		hits = misses = 0;
+		return;
+	}
+	
+	Autolock lock(mutex);
+	
+	hits = cache.hits;
+	misses = cache.misses;
 }
 
-static void EERIE_PATHFINDER_Clear_Private() {
+void EERIE_PATHFINDER_Remove(Entity * io) {
 	
-	PATHFINDER_QUEUE_ELEMENT * cur = pathfinder_queue_start;
-	PATHFINDER_QUEUE_ELEMENT * next;
+	if(workers.empty()) {
+		return;
+	}
 	
-	while(cur) {
-		next = cur->next;
-		delete cur;
-		cur = next;
+	// A result for a request that is currently being processed will be discarded.
+	EntityHandle handle = io->index();
+	if(size_t(handle) < latestRequest.size()) {
+		latestRequest[handle] = 0;
 	}
 	
-	pathfinder_queue_start = NULL;
+	Autolock lock(mutex);
+	
+	for(size_t i = 0; i < requests.size(); i++) {
+		if(requests[i]->handle == handle) {
+			delete requests[i];
+			requests.erase(requests.begin() + i);
+			break;
+		}
+	}
 	
 }
 
-
 void EERIE_PATHFINDER_Clear() {
 	
-	if(!pathfinder) {
+	if(workers.empty()) {
 		return;
 	}
 	
+	// Results for requests that are currently being processed will be discarded.
+	latestRequest.clear();
+	
 	Autolock lock(mutex);
 	
 	EERIE_PATHFINDER_Clear_Private();
 	
 }
 
-// Retrieves & Removes next Pathfind request from queue
-static bool EERIE_PATHFINDER_Get_Next_Request(PATHFINDER_REQUEST & request) {
+static void EERIE_PATHFINDER_Deliver(const PathFinderJob & job) {
 	
-	if(!pathfinder_queue_start || !pathfinder_queue_start->valid) {
-		return false;
+	if(size_t(job.handle) >= latestRequest.size() || latestRequest[job.handle] != job.serial) {
+		// Superseded by a newer request or the entity has been destroyed
+		return;
+	}
+	latestRequest[job.handle] = 0;
+	
+	if(!ValidIONum(job.handle)) {
+		return;
+	}
+	
+	Entity * io = entities[job.handle];
+	if(!(io->ioflags & IO_NPC) || !io->_npcdata || io->_npcdata->behavior == BEHAVIOUR_NONE) {
+		return;
 	}
 	
-	PATHFINDER_QUEUE_ELEMENT * cur = pathfinder_queue_start;
+	IO_PATHFIND & pathfind = io->_npcdata->pathfind;
+	
+	free(pathfind.list);
+	pathfind.list = NULL;
+	
+	if(!job.result.empty()) {
+		long * list = (long*)malloc(job.result.size() * sizeof(long));
+		std::copy(job.result.begin(), job.result.end(), list);
+		pathfind.list = list;
+	}
+	pathfind.listnb = long(job.result.size());
+}
 
-	if ((cur->req.ioid)
-	        && (cur->req.ioid->ioflags & IO_NPC)
-	        && (cur->req.ioid->_npcdata->behavior == BEHAVIOUR_NONE)) {
-		pathfinder_queue_start = cur->next;
-		delete cur;
-		return false;
+void EERIE_PATHFINDER_Update() {
+	
+	if(!mutex) {
+		return;
 	}
+	
+	std::vector<PathFinderJob *> done;
+	{
+		Autolock lock(mutex);
+		done.swap(results);
+	}
+	
+	for(size_t i = 0; i < done.size(); i++) {
+		EERIE_PATHFINDER_Deliver(*done[i]);
+		delete done[i];
+	}
+	
+}
 
-	request = cur->req;
-	pathfinder_queue_start = cur->next;
-	delete cur;
+// Retrieves & Removes next Pathfind request from queue
+// Returns NULL if there are no requests, sets stop if the workers are being released
+static PathFinderJob * EERIE_PATHFINDER_Get_Next_Request(bool & stop) {
+	
+	Autolock lock(mutex);
+	
+	stop = stopping;
+	if(stop || requests.empty()) {
+		return NULL;
+	}
+	
+	PathFinderJob * job = requests.front();
+	requests.pop_front();
+	
+	PATHFINDER_WORKING++;
+	
+	return job;
+}
 
-	return true;
+static void EERIE_PATHFINDER_Finish_Request(PathFinderJob * job) {
+	
+	Autolock lock(mutex);
+	
+	results.push_back(job);
+	
+	PATHFINDER_WORKING--;
+}
+
+static bool EERIE_PATHFINDER_Cache_Lookup(const PathCacheKey & key, PathFinder::Result & result,
+                                          unsigned long & generation) {
+	
+	Autolock lock(mutex);
+	
+	generation = cache.generation;
+	
+	return cache.lookup(key, result);
+}
+
+static void EERIE_PATHFINDER_Cache_Store(const PathCacheKey & key, const PathFinder::Result & result,
+                                         unsigned long generation) {
+	
+	Autolock lock(mutex);
+	
+	// Don't store results computed with anchor data that has since changed
+	if(cache.generation == generation) {
+		cache.store(key, result);
+	}
+}
+
+static void EERIE_PATHFINDER_Process(PathFinder & pathfinder, PathFinderJob & job) {
+	
+	ARX_PROFILE_FUNC();
+	
+	float heuristic(PATHFINDER_HEURISTIC_MAX);
+	
+	pathfinder.setCylinder(job.radius, job.height);
+	
+	bool stealth = (job.behavior & (BEHAVIOUR_SNEAK | BEHAVIOUR_HIDE))
+	               == (BEHAVIOUR_SNEAK | BEHAVIOUR_HIDE);
+	
+	if(   (job.behavior & BEHAVIOUR_MOVE_TO)
+	   || (job.behavior & BEHAVIOUR_GO_HOME)
+	) {
+		float distance = fdist(ACTIVEBKG->anchors[job.from].pos, ACTIVEBKG->anchors[job.to].pos);
+		
+		if(distance < PATHFINDER_DISTANCE_MAX)
+			heuristic = PATHFINDER_HEURISTIC_MIN + PATHFINDER_HEURISTIC_RANGE * (distance / PATHFINDER_DISTANCE_MAX);
+		
+		PathCacheKey key;
+		key.from = job.from;
+		key.to = job.to;
+		key.radius = job.radius;
+		key.height = job.height;
+		key.stealth = stealth;
+		
+		unsigned long generation;
+		if(EERIE_PATHFINDER_Cache_Lookup(key, job.result, generation)) {
+			return;
+		}
+		
+		pathfinder.setHeuristic(heuristic);
+		pathfinder.move(job.from, job.to, job.result, stealth);
+		
+		EERIE_PATHFINDER_Cache_Store(key, job.result, generation);
+	} else if(job.behavior & BEHAVIOUR_WANDER_AROUND) {
+		if(job.behavior_param < PATHFINDER_DISTANCE_MAX)
+			heuristic = PATHFINDER_HEURISTIC_MIN + PATHFINDER_HEURISTIC_RANGE * (job.behavior_param / PATHFINDER_DISTANCE_MAX);
+		
+		pathfinder.setHeuristic(heuristic);
+		pathfinder.wanderAround(job.from, job.behavior_param, job.result, stealth);
+	} else if(job.behavior & (BEHAVIOUR_FLEE | BEHAVIOUR_HIDE)) {
+		if(job.behavior_param < PATHFINDER_DISTANCE_MAX)
+			heuristic = PATHFINDER_HEURISTIC_MIN
+			            + PATHFINDER_HEURISTIC_RANGE
+			              * (job.behavior_param / PATHFINDER_DISTANCE_MAX);
+		
+		pathfinder.setHeuristic(heuristic);
+		float safedist = job.behavior_param + fdist(job.target, job.pos);
+		
+		pathfinder.flee(job.from, job.target, safedist, job.result, stealth);
+	} else if(job.behavior & BEHAVIOUR_LOOK_FOR) {
+		float distance = fdist(job.pos, job.target);
+		
+		if(distance < PATHFINDER_DISTANCE_MAX)
+			heuristic = PATHFINDER_HEURISTIC_MIN + PATHFINDER_HEURISTIC_RANGE * (distance / PATHFINDER_DISTANCE_MAX);
+		
+		pathfinder.setHeuristic(heuristic);
+		pathfinder.lookFor(job.from, job.target, job.behavior_param, job.result, stealth);
+	}
+	
 }
 
 // Pathfinder Thread
@@ -245,112 +542,77 @@ void PathFinderThread::run() {
 	
 	EERIE_BACKGROUND * eb = ACTIVEBKG;
 	PathFinder pathfinder(eb->nbanchors, eb->anchors, MAX_LIGHTS, (EERIE_LIGHT **)GLight);
-
-	while(!isStopRequested()) {
+	pathfinder.setClusters(clusters);
+	unsigned long lightVersion = 0;
+	
+	for(;;) {
 		
-		mutex->lock();
-
-		PATHFINDER_WORKING = 1;
-
-		PATHFINDER_REQUEST curpr;
-		if(EERIE_PATHFINDER_Get_Next_Request(curpr) && curpr.isvalid) {
-			
-			ARX_PROFILE_FUNC();
-			
-			PATHFINDER_WORKING = 2;
-
-			if(curpr.ioid && curpr.ioid->_npcdata) {
-				float heuristic(PATHFINDER_HEURISTIC_MAX);
-
-				pathfinder.setCylinder(curpr.ioid->physics.cyl.radius, curpr.ioid->physics.cyl.height);
-
-				bool stealth = (curpr.ioid->_npcdata->behavior & (BEHAVIOUR_SNEAK | BEHAVIOUR_HIDE))
-				                == (BEHAVIOUR_SNEAK | BEHAVIOUR_HIDE);
-
-				
-				PathFinder::Result result;
-				
-				if(   (curpr.ioid->_npcdata->behavior & BEHAVIOUR_MOVE_TO)
-				   || (curpr.ioid->_npcdata->behavior & BEHAVIOUR_GO_HOME)
-				) {
-					float distance = fdist(ACTIVEBKG->anchors[curpr.from].pos, ACTIVEBKG->anchors[curpr.to].pos);
-
-					if(distance < PATHFINDER_DISTANCE_MAX)
-						heuristic = PATHFINDER_HEURISTIC_MIN + PATHFINDER_HEURISTIC_RANGE * (distance / PATHFINDER_DISTANCE_MAX);
-
-					pathfinder.setHeuristic(heuristic);
-					pathfinder.move(curpr.from, curpr.to, result, stealth);
-				} else if(curpr.ioid->_npcdata->behavior & BEHAVIOUR_WANDER_AROUND) {
-					if(curpr.ioid->_npcdata->behavior_param < PATHFINDER_DISTANCE_MAX)
-						heuristic = PATHFINDER_HEURISTIC_MIN + PATHFINDER_HEURISTIC_RANGE * (curpr.ioid->_npcdata->behavior_param / PATHFINDER_DISTANCE_MAX);
-
-					pathfinder.setHeuristic(heuristic);
-					pathfinder.wanderAround(curpr.from, curpr.ioid->_npcdata->behavior_param, result, stealth);
-				} else if(curpr.ioid->_npcdata->behavior & (BEHAVIOUR_FLEE | BEHAVIOUR_HIDE)) {
-					if(curpr.ioid->_npcdata->behavior_param < PATHFINDER_DISTANCE_MAX)
-						heuristic = PATHFINDER_HEURISTIC_MIN
-						            + PATHFINDER_HEURISTIC_RANGE
-						              * (curpr.ioid->_npcdata->behavior_param / PATHFINDER_DISTANCE_MAX);
-
-					pathfinder.setHeuristic(heuristic);
-					float safedist = curpr.ioid->_npcdata->behavior_param
-					                 + fdist(curpr.ioid->target, curpr.ioid->pos);
-
-					pathfinder.flee(curpr.from, curpr.ioid->target, safedist, result, stealth);
-				} else if(curpr.ioid->_npcdata->behavior & BEHAVIOUR_LOOK_FOR) {
-					float distance = fdist(curpr.ioid->pos, curpr.ioid->target);
-
-					if(distance < PATHFINDER_DISTANCE_MAX)
-						heuristic = PATHFINDER_HEURISTIC_MIN + PATHFINDER_HEURISTIC_RANGE * (distance / PATHFINDER_DISTANCE_MAX);
-
-					pathfinder.setHeuristic(heuristic);
-					pathfinder.lookFor(curpr.from, curpr.ioid->target,
-					                   curpr.ioid->_npcdata->behavior_param, result, stealth);
-				}
-				
-				if(!result.empty()) {
-					long * list = (long*)malloc(result.size() * sizeof(long));
-					std::copy(result.begin(), result.end(), list);
-					*(curpr.returnlist) = list;
-				}
-				*(curpr.returnnumber) = result.size();
-				
-			}
+		wakeup->wait();
+		
+		bool stop;
+		PathFinderJob * job = EERIE_PATHFINDER_Get_Next_Request(stop);
+		if(stop) {
+			break;
 		}
-
-		PATHFINDER_WORKING = 0;
-
-		mutex->unlock();
-		sleep(PATHFINDER_UPDATE_INTERVAL);
+		if(!job) {
+			continue; // The request was removed from the queue before we got to it
+		}
+		
+		if(job->lightVersion != lightVersion) {
+			// Lights have changed since the last search by this worker
+			pathfinder.invalidateLights();
+			lightVersion = job->lightVersion;
+		}
+		
+		EERIE_PATHFINDER_Process(pathfinder, *job);
+		
+		EERIE_PATHFINDER_Finish_Request(job);
 	}
-
-	// fix leaks memory but freeze characters
-	// pathfinder.Clean();
-
-	PATHFINDER_WORKING = 0;
 	
 }
 
 void EERIE_PATHFINDER_Release() {
 	
-	if(!pathfinder) {
+	if(workers.empty()) {
 		return;
 	}
 	
-	mutex->lock();
+	{
+		Autolock lock(mutex);
+		stopping = true;
+	}
 	
-	EERIE_PATHFINDER_Clear_Private();
+	// Each worker exits after its next wakeup
+	for(size_t i = 0; i < workers.size(); i++) {
+		wakeup->post();
+	}
+	
+	// Workers only hold the mutex briefly, so don't hold it while waiting for them.
+	for(size_t i = 0; i < workers.size(); i++) {
+		workers[i]->stop();
+		delete workers[i];
+	}
+	workers.clear();
+	
+	{
+		Autolock lock(mutex);
+		EERIE_PATHFINDER_Clear_Private();
+		PATHFINDER_WORKING = 0;
+		cache.clear();
+		cache.hits = cache.misses = 0;
+	}
 	
-	pathfinder->stop();
+	latestRequest.clear();
 	
-	delete pathfinder, pathfinder = NULL;
+	delete clusters, clusters = NULL;
 	
-	mutex->unlock(), delete mutex, mutex = NULL;
+	delete wakeup, wakeup = NULL;
+	delete mutex, mutex = NULL;
 }
 
 void EERIE_PATHFINDER_Create() {
 	
-	if(pathfinder) {
+	if(!workers.empty()) {
 		EERIE_PATHFINDER_Release();
 	}
 	
@@ -358,7 +620,18 @@ void EERIE_PATHFINDER_Create() {
 		mutex = new Lock();
 	}
 	
-	pathfinder = new PathFinderThread();
-	pathfinder->setThreadName("Pathfinder");
-	pathfinder->start();
+	wakeup = new Semaphore();
+	stopping = false;
+	
+	clusters = new PathClusters(ACTIVEBKG->nbanchors, ACTIVEBKG->anchors);
+	
+	unsigned count = Thread::getProcessorCount();
+	count = std::max(1u, std::min(count - 1, PATHFINDER_MAX_WORKERS));
+	
+	for(unsigned i = 0; i < count; i++) {
+		PathFinderThread * worker = new PathFinderThread();
+		worker->setThreadName("Pathfinder");
+		worker->start();
+		workers.push_back(worker);
+	}
 }
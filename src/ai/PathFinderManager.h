@@ -52,20 +52,45 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 class Entity;
 
 struct PATHFINDER_REQUEST {
-	bool isvalid;
 	long from;
 	long to;
-	long * returnnumber;			// must point to a -1 value at call time
-	// As soon as returnnumber is no more -1
-	// Pathfinding is considered finished
 	Entity * ioid;
-	long ** returnlist;	//must be NULL
 };
 
+//! Number of pathfinder workers currently busy with a request
 extern long PATHFINDER_WORKING;
 
+/*!
+ * Queue a path search for an NPC.
+ * The search parameters (cylinder, behavior, target) are captured at call time.
+ * Once the search is done, the result is stored in the NPC's pathfind.list
+ * and pathfind.listnb by EERIE_PATHFINDER_Update().
+ * A new request from the same NPC overrides any request that is still queued.
+ */
 bool EERIE_PATHFINDER_Add_To_Queue(const PATHFINDER_REQUEST & request);
 long EERIE_PATHFINDER_Get_Queued_Number();
+
+/*!
+ * Deliver finished path searches to their NPCs.
+ * Must be called from the main thread.
+ */
+void EERIE_PATHFINDER_Update();
+
+/*!
+ * Discard all cached paths.
+ * Must be called whenever anchors are blocked or unblocked.
+ */
+void EERIE_PATHFINDER_Invalidate_Cache();
+
+//! Get the number of path cache hits and misses since the pathfinder was created
+void EERIE_PATHFINDER_Get_Cache_Stats(long & hits, long & misses);
+
+/*!
+ * Drop the pending request of an entity that is being destroyed.
+ * Any result for that request that is still being computed will be discarded.
+ */
+void EERIE_PATHFINDER_Remove(Entity * io);
+
 void EERIE_PATHFINDER_Clear();
 void EERIE_PATHFINDER_Create();
 void EERIE_PATHFINDER_Release();
@@ -56,6 +56,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "util/String.h"
 
@@ -84,6 +85,10 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 const size_t MAX_ANIMATIONS = 900;
 std::vector<ANIM_HANDLE> animations(MAX_ANIMATIONS);
 
+//! Index of all allocated entries in animations by path
+typedef boost::unordered_map<res::path, size_t> AnimationIndex;
+static AnimationIndex animationIndex;
+
 static const long anim_power[] = { 100, 20, 15, 12, 8, 6, 5, 4, 3, 2, 2, 1, 1, 1, 1 };
 
 // ANIMATION HANDLES handling
@@ -184,17 +189,25 @@ static void ReleaseAnim(EERIE_ANIM * ea) {
 	free(ea);
 }
 
+static void EERIE_ANIMMANAGER_Clear(long i) {
+	
+	for(long k = 0; k < animations[i].alt_nb; k++) {
+		ReleaseAnim(animations[i].anims[k]);
+		animations[i].anims[k] = NULL;
+	}
+	
+	free(animations[i].anims);
+	animations[i].anims = NULL;
+	
+	animationIndex.erase(animations[i].path);
+	animations[i].path.clear();
+}
+
 void EERIE_ANIMMANAGER_PurgeUnused() {
 	
 	for(size_t i = 0; i < MAX_ANIMATIONS; i++) {
 		if(!animations[i].path.empty() && animations[i].locks == 0) {
-			for(long k = 0; k < animations[i].alt_nb; k++) {
-				ReleaseAnim(animations[i].anims[k]);
-				animations[i].anims[k] = NULL;
-			}
-			free(animations[i].anims);
-			animations[i].anims = NULL;
-			animations[i].path.clear();
+			EERIE_ANIMMANAGER_Clear(i);
 		}
 	}
 }
@@ -212,13 +225,13 @@ void EERIE_ANIMMANAGER_ReleaseHandle(ANIM_HANDLE * anim) {
 
 static ANIM_HANDLE * EERIE_ANIMMANAGER_GetHandle(const res::path & path) {
 	
-	for(size_t i = 0; i < MAX_ANIMATIONS; i++) {
-		if(animations[i].path == path) {
-			return &animations[i];
-		}
+	AnimationIndex::const_iterator it = animationIndex.find(path);
+	if(it == animationIndex.end()) {
+		return NULL;
 	}
 	
-	return NULL;
+	arx_assert(animations[it->second].path == path);
+	return &animations[it->second];
 }
 
 static float GetTimeBetweenKeyFrames(EERIE_ANIM * ea, long f1, long f2) {
@@ -533,6 +546,7 @@ ANIM_HANDLE * EERIE_ANIMMANAGER_Load_NoWarning(const res::path & path) {
 		
 		animations[i].path = path;
 		animations[i].locks = 1;
+		animationIndex[path] = i;
 		
 		int pathcount = 2;
 		res::path altpath;
@@ -729,19 +743,6 @@ void ResetAnim(AnimLayer & layer) {
 	layer.flags&=~EA_FORCEPLAY;
 }
 
-static void EERIE_ANIMMANAGER_Clear(long i) {
-	
-	for(long k = 0; k < animations[i].alt_nb; k++) {
-		ReleaseAnim(animations[i].anims[k]);
-		animations[i].anims[k] = NULL;
-	}
-	
-	free(animations[i].anims);
-	animations[i].anims = NULL;
-	
-	animations[i].path.clear();
-}
-
 void EERIE_ANIMMANAGER_ClearAll() {
 	
 	for(size_t i = 0; i < MAX_ANIMATIONS; i++) {
@@ -80,6 +80,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "physics/Collisions.h"
 
 #include "platform/Platform.h"
+#include "platform/Thread.h"
+#include "platform/ThreadPool.h"
 #include "platform/profiler/Profiler.h"
 
 #include "scene/Light.h"
@@ -1171,7 +1173,10 @@ static void Cedric_AnimateDrawEntityRender(EERIE_3DOBJ * eobj, const Vec3f & pos
 
 	UpdateLlights(tv, false);
 
-	Cedric_ApplyLighting(eobj, obj, colorMod);
+	// Distant entities keep the lighting from the last full update
+	if(!io || !io->animLod.skipped) {
+		Cedric_ApplyLighting(eobj, obj, colorMod);
+	}
 
 	Cedric_RenderObject(eobj, obj, io, pos, invisibility);
 
@@ -1407,46 +1412,39 @@ static void Cedric_ConcatenateTM(Skeleton & rig, const TransformInfo & t) {
 static void Cedric_TransformVerts(EERIE_3DOBJ * eobj, const Vec3f & pos) {
 
 	Skeleton & rig = *eobj->m_skeleton;
-
-	// Transform & project all vertices
+	
+	// Local vertices are stored in bone order, see EERIE_CreateCedricData()
+	const Vec3f * inVert = eobj->vertexlocal;
+	
+	bool updateLocal = (eobj->sdata != NULL);
+	
+	// Transform all vertices
 	for(size_t i = 0; i != rig.bones.size(); i++) {
 		Bone & bone = rig.bones[i];
-
-		glm::mat4x4 matrix = glm::toMat4(bone.anim.quat);
 		
-		// Apply Scale
-		matrix[0][0] *= bone.anim.scale.x;
-		matrix[0][1] *= bone.anim.scale.x;
-		matrix[0][2] *= bone.anim.scale.x;
-
-		matrix[1][0] *= bone.anim.scale.y;
-		matrix[1][1] *= bone.anim.scale.y;
-		matrix[1][2] *= bone.anim.scale.y;
-
-		matrix[2][0] *= bone.anim.scale.z;
-		matrix[2][1] *= bone.anim.scale.z;
-		matrix[2][2] *= bone.anim.scale.z;
-
+		// Rotation and scale only - the translation is added separately
+		glm::mat3x3 matrix = glm::toMat3(bone.anim.quat);
+		matrix[0] *= bone.anim.scale.x;
+		matrix[1] *= bone.anim.scale.y;
+		matrix[2] *= bone.anim.scale.z;
+		
 		Vec3f vector = bone.anim.trans;
-
-		for(size_t v = 0; v != bone.idxvertices.size(); v++) {
+		
+		for(size_t v = 0; v != bone.idxvertices.size(); v++, inVert++) {
 			long index = bone.idxvertices[v];
-
-			Vec3f & inVert = eobj->vertexlocal[index];
-			EERIE_VERTEX & outVert = eobj->vertexlist3[index];
 			
-			outVert.v = Vec3f(matrix * Vec4f(inVert, 1.f));
-			outVert.v += vector;
+			EERIE_VERTEX & outVert = eobj->vertexlist3[index];
 			
+			outVert.v = matrix * *inVert + vector;
 			outVert.vert.p = outVert.v;
+			
+			if(updateLocal) {
+				eobj->vertexlist[index].vert.p = outVert.v - pos;
+			}
 		}
 	}
-
-	if(eobj->sdata) {
-		for(size_t i = 0; i < eobj->vertexlist.size(); i++) {
-			eobj->vertexlist[i].vert.p = eobj->vertexlist3[i].v - pos;
-		}
-	}
+	
+	arx_assert(inVert == eobj->vertexlocal + eobj->vertexlist.size());
 }
 
 static void Cedric_ViewProjectTransform(EERIE_3DOBJ * eobj) {
@@ -1524,9 +1522,33 @@ static void Cedric_AnimateDrawEntity(Skeleton & skeleton, AnimLayer * animlayer,
 	}
 }
 
-void EERIEDrawAnimQuatUpdate(EERIE_3DOBJ *eobj, AnimLayer * animlayer,const Anglef & angle, const Vec3f & pos, unsigned long time, Entity *io, bool update_movement) {
+/*!
+ * Skeleton and mesh update for one entity.
+ * This only writes to the entity's own skeleton, mesh, blend status and bounding boxes
+ * and can run concurrently for different entities.
+ */
+struct AnimQuatSkinning {
+	
+	EERIE_3DOBJ * eobj;
+	AnimLayer * animlayer;
+	Anglef angle;
+	Vec3f pos;
+	Entity * io;
+	Vec3f ftr;
+	float scale;
+	
+	bool full; // Otherwise only move the previous pose by offset
+	Vec3f offset;
+	
+};
 
-	ARX_PROFILE_FUNC();
+/*!
+ * Advance the animation time and apply movement.
+ * \return true if the skeleton and mesh need to be updated.
+ */
+static bool EERIEDrawAnimQuatAdvance(EERIE_3DOBJ * eobj, AnimLayer * animlayer, const Anglef & angle,
+                                     const Vec3f & pos, unsigned long time, Entity * io,
+                                     bool update_movement, AnimQuatSkinning & skinning) {
 	
 	if(io) {
 		float speedfactor = io->basespeed + io->speed_modif;
@@ -1570,16 +1592,60 @@ void EERIEDrawAnimQuatUpdate(EERIE_3DOBJ *eobj, AnimLayer * animlayer,const Angl
 		StoreEntityMovement(io, ftr, scale);
 
 	if(io && io != entities.player() && !Cedric_IO_Visible(io->pos))
-		return;
+		return false;
+	
+	skinning.eobj = eobj;
+	skinning.animlayer = animlayer;
+	skinning.angle = angle;
+	skinning.pos = pos;
+	skinning.io = io;
+	skinning.ftr = ftr;
+	skinning.scale = scale;
+	skinning.full = true;
+	
+	return true;
+}
 
+/*!
+ * Move the pose from the last full update along with the entity.
+ * The mesh still needs to be projected again as the camera may have moved.
+ */
+static void EERIEDrawAnimQuatMove(const AnimQuatSkinning & skinning) {
+	
+	EERIE_3DOBJ * eobj = skinning.eobj;
+	Entity * io = skinning.io;
+	
+	for(size_t i = 0; i < eobj->vertexlist.size(); i++) {
+		eobj->vertexlist3[i].v += skinning.offset;
+	}
+	
+	io->bbox3D.min += skinning.offset;
+	io->bbox3D.max += skinning.offset;
+	
+	Cedric_ViewProjectTransform(eobj);
+	Cedric_UpdateBbox2d(*eobj, io->bbox2D);
+}
+
+static void EERIEDrawAnimQuatSkin(const AnimQuatSkinning & skinning) {
+	
+	ARX_PROFILE_FUNC();
+	
+	if(!skinning.full) {
+		EERIEDrawAnimQuatMove(skinning);
+		return;
+	}
+	
+	EERIE_3DOBJ * eobj = skinning.eobj;
+	Entity * io = skinning.io;
+	
 	glm::quat rotation;
 
 	bool isNpc = io && (io->ioflags & IO_NPC);
 	if(!isNpc) {
 		// To correct invalid angle in Animated FIX/ITEMS
-		rotation = glm::toQuat(toRotationMatrix(angle));
+		rotation = glm::toQuat(toRotationMatrix(skinning.angle));
 	} else {
-		rotation = QuatFromAngles(angle);
+		rotation = QuatFromAngles(skinning.angle);
 	}
 
 	EERIE_EXTRA_ROTATE * extraRotation = NULL;
@@ -1603,13 +1669,13 @@ void EERIEDrawAnimQuatUpdate(EERIE_3DOBJ *eobj, AnimLayer * animlayer,const Angl
 	arx_assert(eobj->m_skeleton);
 	Skeleton & skeleton = *eobj->m_skeleton;
 
-	Cedric_AnimateDrawEntity(skeleton, animlayer, extraRotation, animBlend, extraScale);
+	Cedric_AnimateDrawEntity(skeleton, skinning.animlayer, extraRotation, animBlend, extraScale);
 
 	// Build skeleton in Object Space
-	TransformInfo t(pos, rotation, scale, ftr);
+	TransformInfo t(skinning.pos, rotation, skinning.scale, skinning.ftr);
 	Cedric_ConcatenateTM(skeleton, t);
 
-	Cedric_TransformVerts(eobj, pos);
+	Cedric_TransformVerts(eobj, skinning.pos);
 	if(io) {
 		UpdateBbox3d(eobj, io->bbox3D);
 	}
@@ -1620,6 +1686,118 @@ void EERIEDrawAnimQuatUpdate(EERIE_3DOBJ *eobj, AnimLayer * animlayer,const Angl
 	}
 }
 
+void EERIEDrawAnimQuatUpdate(EERIE_3DOBJ *eobj, AnimLayer * animlayer,const Anglef & angle, const Vec3f & pos, unsigned long time, Entity *io, bool update_movement) {
+
+	ARX_PROFILE_FUNC();
+	
+	AnimQuatSkinning skinning;
+	if(EERIEDrawAnimQuatAdvance(eobj, animlayer, angle, pos, time, io, update_movement, skinning)) {
+		EERIEDrawAnimQuatSkin(skinning);
+	}
+}
+
+namespace {
+
+class AnimQuatSkinningTask : public ThreadPool::Task {
+	
+public:
+	
+	std::vector<AnimQuatSkinning> entities;
+	
+	void run(size_t index) {
+		EERIEDrawAnimQuatSkin(entities[index]);
+	}
+	
+};
+
+} // anonymous namespace
+
+static AnimQuatSkinningTask g_deferredSkinning;
+static ThreadPool * g_skinningThreads = NULL;
+
+//! Distance from the camera after which the animation level of detail is reduced
+static const float ANIMATION_LOD_DISTANCE = 1200.f;
+static const unsigned ANIMATION_LOD_MAX = 2;
+
+static unsigned getAnimationLod(const Entity * io) {
+	
+	// Keep full detail for anything that might be interacting with the player
+	if(io->animBlend.m_active || ((io->ioflags & IO_NPC) && (io->_npcdata->behavior & BEHAVIOUR_FIGHT))) {
+		return 0;
+	}
+	
+	float dist = fdist(io->pos, ACTIVECAM->orgTrans.pos);
+	
+	unsigned level = 0;
+	while(level < ANIMATION_LOD_MAX && dist > ANIMATION_LOD_DISTANCE * float(1 << level)) {
+		level++;
+	}
+	
+	return level;
+}
+
+void EERIEDrawAnimQuatUpdateDeferred(EERIE_3DOBJ * eobj, AnimLayer * animlayer, const Anglef & angle,
+                                     const Vec3f & pos, unsigned long time, Entity * io,
+                                     bool update_movement) {
+	
+	ARX_PROFILE_FUNC();
+	
+	AnimQuatSkinning skinning;
+	if(!EERIEDrawAnimQuatAdvance(eobj, animlayer, angle, pos, time, io, update_movement, skinning)) {
+		if(io) {
+			io->animLod.valid = false;
+			io->animLod.skipped = 0;
+		}
+		return;
+	}
+	
+	if(io) {
+		AnimationLodStatus & lod = io->animLod;
+		lod.level = getAnimationLod(io);
+		// The held pose can only be reused for the same mesh and orientation
+		if(lod.obj != eobj || lod.vertexCount != eobj->vertexlist.size() || !(lod.angle == angle)) {
+			lod.valid = false;
+		}
+		if(lod.valid && lod.skipped + 1 < (1u << lod.level)) {
+			lod.skipped++;
+			skinning.full = false;
+			skinning.offset = pos - lod.pos;
+		} else {
+			lod.skipped = 0;
+			lod.valid = true;
+			lod.angle = angle;
+			lod.obj = eobj;
+			lod.vertexCount = eobj->vertexlist.size();
+		}
+		lod.pos = pos;
+	}
+	
+	g_deferredSkinning.entities.push_back(skinning);
+}
+
+void EERIEDrawAnimQuatFlush() {
+	
+	ARX_PROFILE_FUNC();
+	
+	if(g_deferredSkinning.entities.empty()) {
+		return;
+	}
+	
+	if(!g_skinningThreads) {
+		size_t threads = std::min(Thread::getProcessorCount(), 4u) - 1;
+		g_skinningThreads = new ThreadPool(threads, "Skinning");
+	}
+	
+	g_skinningThreads->run(g_deferredSkinning, g_deferredSkinning.entities.size());
+	
+	g_deferredSkinning.entities.clear();
+}
+
+void EERIEDrawAnimQuatRelease() {
+	arx_assert(g_deferredSkinning.entities.empty());
+	delete g_skinningThreads, g_skinningThreads = NULL;
+}
+
 void EERIEDrawAnimQuatRender(EERIE_3DOBJ *eobj, const Vec3f & pos, Entity *io, float invisibility) {
 
 	ARX_PROFILE_FUNC();
@@ -98,6 +98,26 @@ void DrawEERIEInter_Render(EERIE_3DOBJ *eobj, const TransformInfo &t, Entity *io
 void DrawEERIEInter(EERIE_3DOBJ *eobj, const TransformInfo & t, Entity *io, bool forceDraw = false, float invisibility = 0.f);
 
 void EERIEDrawAnimQuatUpdate(EERIE_3DOBJ *eobj, AnimLayer * animlayer,const Anglef & angle, const Vec3f & pos, unsigned long time, Entity *io, bool update_movement);
+
+/*!
+ * Like \ref EERIEDrawAnimQuatUpdate, but only advance the animation and apply movement.
+ * Updating the skeleton and mesh is deferred until the next call to
+ * \ref EERIEDrawAnimQuatFlush so that multiple entities can be skinned in parallel.
+ * Entities passed to this function must not share the same object.
+ *
+ * Distant entities only get a full skeleton update every few frames, in between
+ * their last pose is moved along with the entity and lighting is not recalculated.
+ * The current level of detail is stored in Entity::animLod.
+ */
+void EERIEDrawAnimQuatUpdateDeferred(EERIE_3DOBJ * eobj, AnimLayer * animlayer, const Anglef & angle,
+                                     const Vec3f & pos, unsigned long time, Entity * io,
+                                     bool update_movement);
+
+//! Update the skeletons and meshes for all deferred entity updates
+void EERIEDrawAnimQuatFlush();
+
+//! Stop the worker threads used by \ref EERIEDrawAnimQuatFlush
+void EERIEDrawAnimQuatRelease();
 void EERIEDrawAnimQuatRender(EERIE_3DOBJ *eobj, const Vec3f & pos, Entity *io, float invisibility);
 
 void EERIEDrawAnimQuat(EERIE_3DOBJ *eobj, AnimLayer * animlayer, const Anglef & angle, const Vec3f & pos, unsigned long time, Entity *io, bool update_movement = true, float invisibility = 0.f);
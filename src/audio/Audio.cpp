@@ -65,9 +65,85 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 namespace audio {
 
 namespace {
+
 static Lock * mutex = NULL;
+
+/*!
+ * Source and listener parameter changes that are applied later by whoever holds the mutex.
+ * This lets the game thread update positions and volumes without waiting for the
+ * update thread to finish refilling stream buffers.
+ */
+struct Command {
+	
+	enum Type {
+		ListenerPosition,
+		ListenerDirection,
+		SampleVolume,
+		SamplePitch,
+		SamplePosition
+	};
+	
+	Type type;
+	SourceId source;
+	float value;
+	Vec3f vector1;
+	Vec3f vector2;
+	
+	explicit Command(Type _type, SourceId _source = INVALID_ID)
+		: type(_type), source(_source), value(0.f), vector1(0.f), vector2(0.f) { }
+	
+};
+
+static Lock * commandMutex = NULL;
+static std::vector<Command> queuedCommands; // Protected by commandMutex
+static std::vector<Command> runningCommands; // Protected by mutex
+
+static void queueCommand(const Command & command) {
+	Autolock lock(commandMutex);
+	queuedCommands.push_back(command);
+}
+
+//! Apply queued commands - must be called with the mutex held
+static void applyCommands() {
+	
+	{
+		Autolock lock(commandMutex);
+		if(queuedCommands.empty()) {
+			return;
+		}
+		queuedCommands.swap(runningCommands);
+	}
+	
+	for(std::vector<Command>::const_iterator i = runningCommands.begin();
+	    i != runningCommands.end(); ++i) {
+		
+		if(i->type == Command::ListenerPosition) {
+			backend->setListenerPosition(i->vector1);
+			continue;
+		} else if(i->type == Command::ListenerDirection) {
+			backend->setListenerOrientation(i->vector1, i->vector2);
+			continue;
+		}
+		
+		Source * source = backend->getSource(i->source);
+		if(!source) {
+			continue;
+		}
+		
+		switch(i->type) {
+			case Command::SampleVolume: source->setVolume(i->value); break;
+			case Command::SamplePitch: source->setPitch(i->value); break;
+			case Command::SamplePosition: source->setPosition(i->vector1); break;
+			default: arx_assert(false);
+		}
+		
+	}
+	
+	runningCommands.clear();
 }
 
+} // anonymous namespace
+
 aalError init(const std::string & backendName, const std::string & deviceName) {
 	
 	// Clean any initialized data
@@ -76,6 +152,7 @@ aalError init(const std::string & backendName, const std::string & deviceName) {
 	LogDebug("Init");
 	
 	stream_limit_bytes = DEFAULT_STREAMLIMIT;
+	cache_limit_bytes = DEFAULT_CACHELIMIT;
 	
 	bool autoBackend = (backendName == "auto");
 	aalError error = AAL_ERROR_INIT;
@@ -123,6 +200,7 @@ aalError init(const std::string & backendName, const std::string & deviceName) {
 	}
 	
 	mutex = new Lock();
+	commandMutex = new Lock();
 	
 	session_time = platform::getTimeMs();
 	
@@ -148,7 +226,14 @@ aalError clean() {
 	ambiance_path.clear();
 	environment_path.clear();
 	
+	{
+		Autolock lock(commandMutex);
+		queuedCommands.clear();
+	}
+	runningCommands.clear();
+	
 	delete mutex, mutex = NULL;
+	delete commandMutex, commandMutex = NULL;
 	
 	return AAL_OK;
 }
@@ -157,13 +242,20 @@ aalError clean() {
 	if(!backend) { \
 		return AAL_ERROR_INIT; \
 	} \
-	Autolock lock(mutex);
+	Autolock lock(mutex); \
+	applyCommands();
 
 #define AAL_ENTRY_V(value) \
 	if(!backend) { \
 		return (value); \
 	} \
-	Autolock lock(mutex);
+	Autolock lock(mutex); \
+	applyCommands();
+
+#define AAL_ENTRY_QUEUED \
+	if(!backend) { \
+		return AAL_ERROR_INIT; \
+	}
 
 std::vector<std::string> getDevices() {
 	
@@ -181,6 +273,15 @@ aalError setStreamLimit(size_t limit) {
 	return AAL_OK;
 }
 
+aalError setCacheLimit(size_t limit) {
+	
+	AAL_ENTRY
+	
+	cache_limit_bytes = limit;
+	
+	return AAL_OK;
+}
+
 aalError setSamplePath(const res::path & path) {
 	
 	AAL_ENTRY
@@ -410,16 +511,25 @@ aalError setRolloffFactor(float factor) {
 
 aalError setListenerPosition(const Vec3f & position) {
 	
-	AAL_ENTRY
+	AAL_ENTRY_QUEUED
 	
-	return backend->setListenerPosition(position);
+	Command command(Command::ListenerPosition);
+	command.vector1 = position;
+	queueCommand(command);
+	
+	return AAL_OK;
 }
 
 aalError setListenerDirection(const Vec3f & front, const Vec3f & up) {
 	
-	AAL_ENTRY
+	AAL_ENTRY_QUEUED
+	
+	Command command(Command::ListenerDirection);
+	command.vector1 = front;
+	command.vector2 = up;
+	queueCommand(command);
 	
-	return backend->setListenerOrientation(front, up);
+	return AAL_OK;
 }
 
 aalError setListenerEnvironment(EnvId e_id) {
@@ -506,40 +616,39 @@ aalError mixerResume(MixerId m_id) {
 
 // Sample setup
 
+// Source and listener parameters are applied asynchronously, so invalid ids are not reported
+
 aalError setSampleVolume(SourceId sample_id, float volume) {
 	
-	AAL_ENTRY
+	AAL_ENTRY_QUEUED
 	
-	Source * source = backend->getSource(sample_id);
-	if(!source) {
-		return AAL_ERROR_HANDLE;
-	}
+	Command command(Command::SampleVolume, sample_id);
+	command.value = volume;
+	queueCommand(command);
 	
-	return source->setVolume(volume);
+	return AAL_OK;
 }
 
 aalError setSamplePitch(SourceId sample_id, float pitch) {
 	
-	AAL_ENTRY
+	AAL_ENTRY_QUEUED
 	
-	Source * source = backend->getSource(sample_id);
-	if(!source) {
-		return AAL_ERROR_HANDLE;
-	}
+	Command command(Command::SamplePitch, sample_id);
+	command.value = pitch;
+	queueCommand(command);
 	
-	return source->setPitch(pitch);
+	return AAL_OK;
 }
 
 aalError setSamplePosition(SourceId sample_id, const Vec3f & position) {
 	
-	AAL_ENTRY
+	AAL_ENTRY_QUEUED
 	
-	Source * source = backend->getSource(sample_id);
-	if(!source) {
-		return AAL_ERROR_HANDLE;
-	}
+	Command command(Command::SamplePosition, sample_id);
+	command.vector1 = position;
+	queueCommand(command);
 	
-	return source->setPosition(position);
+	return AAL_OK;
 }
 
 // Sample status
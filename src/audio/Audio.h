@@ -75,6 +75,12 @@ std::vector<std::string> getDevices();
  */
 aalError clean();
 aalError setStreamLimit(size_t size);
+/*!
+ * Set how many bytes of decoded sample data to keep after the last source playing it is gone.
+ * Cached samples can be played again without reading and decoding the file.
+ * Least recently used samples are dropped first once the limit is reached.
+ */
+aalError setCacheLimit(size_t size);
 aalError setSamplePath(const res::path & path);
 aalError setAmbiancePath(const res::path & path);
 aalError setEnvironmentPath(const res::path & path);
@@ -116,6 +122,11 @@ aalError mixerResume(MixerId mixer_id);
 
 // Sample
 
+/*!
+ * Source parameter and listener position changes are queued and applied the next time
+ * the audio state is accessed or updated. Their return value does not reflect whether
+ * the source id was valid.
+ */
 aalError setSampleVolume(SourceId sample_id, float volume);
 aalError setSamplePitch(SourceId sample_id, float pitch);
 aalError setSamplePosition(SourceId sample_id, const Vec3f & position);
@@ -60,6 +60,7 @@ res::path sample_path;
 res::path ambiance_path;
 res::path environment_path;
 size_t stream_limit_bytes = DEFAULT_STREAMLIMIT;
+size_t cache_limit_bytes = DEFAULT_CACHELIMIT;
 size_t session_time = 0;
 
 // Resources
@@ -72,6 +72,7 @@ extern res::path sample_path;
 extern res::path ambiance_path;
 extern res::path environment_path;
 extern size_t stream_limit_bytes;
+extern size_t cache_limit_bytes;
 extern size_t session_time;
 
 // Resources
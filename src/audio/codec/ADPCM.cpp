@@ -44,6 +44,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "audio/codec/ADPCM.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "audio/AudioTypes.h"
 #include "audio/codec/WAVFormat.h"
@@ -59,21 +60,13 @@ static const short gai_p4[] = {
 
 CodecADPCM::CodecADPCM() :
 	stream(NULL), header(NULL), padding(0), shift(0),
-	sample_i(0xffffffff), predictor(NULL), delta(NULL),
-	samp1(NULL), samp2(NULL), coef1(NULL), coef2(NULL),
-	nybble_l(NULL), nybble_c(0), nybble_i(0), nybble(0), odd(false),
-	cache_c(0), cache_i(0), cache_l(NULL), cursor(0) {
+	nybble_l(NULL), nybble_c(0), block_l(NULL), block_c(0), block_i(0),
+	decoded(false), cursor(0) {
 }
 
 CodecADPCM::~CodecADPCM() {
-	delete[] predictor;
-	delete[] delta;
-	delete[] samp1;
-	delete[] samp2;
-	delete[] coef1;
-	delete[] coef2;
-	delete[] (s8*)cache_l;
 	delete[] nybble_l;
+	delete[] block_l;
 }
 
 aalError CodecADPCM::setHeader(void * _header) {
@@ -88,36 +81,23 @@ aalError CodecADPCM::setHeader(void * _header) {
 		return AAL_ERROR_FORMAT;
 	}
 	
-	shift = header->wfx.channels - 1;
-	padding = 0;
-	sample_i = 0xffffffff;
-	
-	size_t nb = 1 << shift;
-	
-	predictor = new char[nb];
-	delta = new s16[nb];
-	coef1 = new s16[nb];
-	coef2 = new s16[nb];
-	samp1 = new s16[nb];
-	samp2 = new s16[nb];
-	if(!predictor || !delta || !coef1 || !coef2 || !samp1 || !samp2) {
-		return AAL_ERROR_MEMORY;
+	if(header->samplesPerBlock < 2) {
+		return AAL_ERROR_FORMAT;
 	}
 	
-	cache_c = cache_i = (u8)(sizeof(s16) << shift);
-	cache_l = new s8[cache_c];
-	if(!cache_l) {
-		return AAL_ERROR_MEMORY;
-	}
+	shift = header->wfx.channels - 1;
+	padding = 0;
 	
 	nybble_c = header->samplesPerBlock - 2;
 	if(!shift) {
 		nybble_c >>= 1;
 	}
-	nybble_l = new s8[nybble_c];
-	if(!nybble_l) {
-		return AAL_ERROR_MEMORY;
-	}
+	// Reserve space for an incomplete last byte so that decodeBlock() never reads past the end
+	nybble_l = new u8[nybble_c + 1];
+	nybble_l[nybble_c] = 0;
+	
+	block_c = size_t(header->samplesPerBlock) * (sizeof(s16) << shift);
+	block_l = new s16[header->samplesPerBlock << shift];
 	
 	padding = ((header->wfx.blockAlign - (7 << shift)) << 3) -
 	          (header->samplesPerBlock - 2) * (header->wfx.bitsPerSample << shift);
@@ -126,7 +106,8 @@ aalError CodecADPCM::setHeader(void * _header) {
 		return error;
 	}
 	
-	sample_i++;
+	// The first sample is skipped at the start of the stream
+	block_i = sizeof(s16) << shift;
 	
 	return AAL_OK;
 }
@@ -150,9 +131,6 @@ aalError CodecADPCM::setPosition(size_t _position) {
 		return error;
 	}
 	
-	sample_i++;
-	cache_i = 0;
-	
 	while(i) {
 		char buffer[256];
 		size_t nRead;
@@ -172,28 +150,24 @@ size_t CodecADPCM::getPosition() {
 	return cursor;
 }
 
-void CodecADPCM::getSample(size_t i, s8 adpcm_sample) {
+static inline s16 decodeNybble(s16 & delta, s16 & samp1, s16 & samp2, s32 coef1, s32 coef2,
+                               u8 nybble) {
 	
 	// Update delta
-	s32 old_delta = delta[i];
-	delta[i] = s16((gai_p4[adpcm_sample] * old_delta) >> 8);
-	
-	if(delta[i] < 16) {
-		delta[i] = 16;
+	s32 old_delta = delta;
+	delta = s16((gai_p4[nybble] * old_delta) >> 8);
+	if(delta < 16) {
+		delta = 16;
 	}
 	
-	// Sign-extend adpcm_sample
-	if(adpcm_sample & 0x08) {
-		adpcm_sample -= 16;
-	}
+	// Sign-extend the sample
+	s32 sample = (nybble & 0x08) ? s32(nybble) - 16 : s32(nybble);
 	
 	// Predict next sample
-	s32 predict = ((s32)samp1[i] * coef1[i] + (s32)samp2[i] * coef2[i]) >> 8;
-	
-	// Reconstruct original PCM
-	s32 pcm_sample = adpcm_sample * old_delta + predict;
+	s32 predict = (s32(samp1) * coef1 + s32(samp2) * coef2) >> 8;
 	
-	// Clip value to signed 16 bits limits
+	// Reconstruct original PCM and clip value to signed 16 bits limits
+	s32 pcm_sample = sample * old_delta + predict;
 	if(pcm_sample > 32767) {
 		pcm_sample = 32767;
 	} else if(pcm_sample < -32768) {
@@ -201,8 +175,58 @@ void CodecADPCM::getSample(size_t i, s8 adpcm_sample) {
 	}
 	
 	// Update samples
-	samp2[i] = samp1[i];
-	samp1[i] = (s16)pcm_sample;
+	samp2 = samp1;
+	samp1 = s16(pcm_sample);
+	
+	return samp1;
+}
+
+void CodecADPCM::decodeBlock(s16 * output) {
+	
+	size_t count = header->samplesPerBlock - 2;
+	const u8 * input = nybble_l;
+	
+	// Work on local copies of the channel state so that it can stay in registers
+	
+	if(shift) {
+		
+		s16 delta0 = channel[0].delta, samp10 = channel[0].samp1, samp20 = channel[0].samp2;
+		s16 delta1 = channel[1].delta, samp11 = channel[1].samp1, samp21 = channel[1].samp2;
+		s32 coef10 = channel[0].coef1, coef20 = channel[0].coef2;
+		s32 coef11 = channel[1].coef1, coef21 = channel[1].coef2;
+		
+		*output++ = samp20;
+		*output++ = samp21;
+		*output++ = samp10;
+		*output++ = samp11;
+		
+		// One byte per sample frame: left channel in the high nybble, right in the low nybble
+		for(size_t i = 0; i < count; i++) {
+			u8 byte = input[i];
+			*output++ = decodeNybble(delta0, samp10, samp20, coef10, coef20, u8(byte >> 4));
+			*output++ = decodeNybble(delta1, samp11, samp21, coef11, coef21, u8(byte & 0x0f));
+		}
+		
+	} else {
+		
+		s16 delta = channel[0].delta, samp1 = channel[0].samp1, samp2 = channel[0].samp2;
+		s32 coef1 = channel[0].coef1, coef2 = channel[0].coef2;
+		
+		*output++ = samp2;
+		*output++ = samp1;
+		
+		// Two samples per byte, high nybble first
+		for(size_t i = 0; i < count / 2; i++) {
+			u8 byte = input[i];
+			*output++ = decodeNybble(delta, samp1, samp2, coef1, coef2, u8(byte >> 4));
+			*output++ = decodeNybble(delta, samp1, samp2, coef1, coef2, u8(byte & 0x0f));
+		}
+		if(count & 1) {
+			*output++ = decodeNybble(delta, samp1, samp2, coef1, coef2, u8(input[count / 2] >> 4));
+		}
+		
+	}
+	
 }
 
 aalError CodecADPCM::read(void * buffer, size_t to_read, size_t & read) {
@@ -210,14 +234,8 @@ aalError CodecADPCM::read(void * buffer, size_t to_read, size_t & read) {
 	read = 0;
 	while(read < to_read) {
 		
-		// If prefetched bytes are remaining, put the next one into the buffer
-		if(cache_i < cache_c) {
-			((s8 *)buffer)[read++] = ((s8 *)cache_l)[cache_i++];
-			continue;
-		}
-		
-		// Load next block header if there is no more sample in current one
-		if(sample_i >= header->samplesPerBlock) {
+		// Load next block if there are no more samples in current one
+		if(block_i == block_c) {
 			
 			if(padding) {
 				stream->seek(SeekCur, padding);
@@ -226,29 +244,24 @@ aalError CodecADPCM::read(void * buffer, size_t to_read, size_t & read) {
 			if(aalError error = getNextBlock()) {
 				return error;
 			}
-			
-		} else if(sample_i == 1) {
-			for(size_t i = 0; i < header->wfx.channels; i++) {
-				((s16 *)cache_l)[i] = samp1[i];
-			}
+		}
+		
+		char * output = (char *)buffer + read;
+		size_t count = std::min(to_read - read, block_c - block_i);
+		
+		if(count == block_c && !decoded && size_t(output) % sizeof(s16) == 0) {
+			// Decode the whole block directly into the output buffer
+			decodeBlock(reinterpret_cast<s16 *>(output));
 		} else {
-			
-			// Get new sample for each channel
-			for(size_t i = 0; i < header->wfx.channels; i++) {
-				if(odd) {
-					getSample(i, (s8)(nybble & 0x0f));
-					odd = false;
-				} else {
-					nybble = nybble_l[nybble_i++];
-					getSample(i, s8((nybble >> 4) & 0x0f));
-					odd = true;
-				}
-				((s16 *)cache_l)[i] = samp1[i];
+			if(!decoded) {
+				decodeBlock(block_l);
+				decoded = true;
 			}
+			memcpy(output, (const char *)block_l + block_i, count);
 		}
 		
-		sample_i++;
-		cache_i = 0;
+		block_i += count;
+		read += count;
 	}
 	
 	return AAL_OK;
@@ -257,39 +270,35 @@ aalError CodecADPCM::read(void * buffer, size_t to_read, size_t & read) {
 aalError CodecADPCM::getNextBlock() {
 	
 	// Load and check block header
-	if(!stream->read(predictor, sizeof(*predictor) << shift)) {
+	size_t channels = header->wfx.channels;
+	u8 block_header[7 * 2];
+	size_t header_size = 7 << shift;
+	if(stream->read(block_header, header_size) != header_size) {
 		return AAL_ERROR_FILEIO;
 	}
 	
-	if(!stream->read(delta, sizeof(*delta) << shift)) {
-		return AAL_ERROR_FILEIO;
-	}
-	
-	if(!stream->read(samp1, sizeof(*samp1) << shift)) {
-		return AAL_ERROR_FILEIO;
-	}
-	
-	if(!stream->read(samp2, sizeof(*samp2) << shift)) {
-		return AAL_ERROR_FILEIO;
-	}
-	
-	odd = false;
-	sample_i = 0;
-	nybble_i = 0;
-	
-	for(size_t i = 0; i < header->wfx.channels; i++) {
-		if(predictor[i] >= header->coefficientCount) {
+	for(size_t i = 0; i < channels; i++) {
+		
+		u8 predictor = block_header[i];
+		if(predictor >= header->coefficientCount) {
 			return AAL_ERROR_FORMAT;
 		}
-		coef1[i] = header->coefficients[(size_t)predictor[i]].coef1;
-		coef2[i] = header->coefficients[(size_t)predictor[i]].coef2;
-		((s16 *)cache_l)[i] = samp2[i];
+		
+		Channel & c = channel[i];
+		memcpy(&c.delta, block_header + channels + 2 * i, sizeof(s16));
+		memcpy(&c.samp1, block_header + channels * 3 + 2 * i, sizeof(s16));
+		memcpy(&c.samp2, block_header + channels * 5 + 2 * i, sizeof(s16));
+		c.coef1 = header->coefficients[predictor].coef1;
+		c.coef2 = header->coefficients[predictor].coef2;
 	}
 	
 	if(!stream->read(nybble_l, nybble_c)) {
 		return AAL_ERROR_FILEIO;
 	}
 	
+	block_i = 0;
+	decoded = false;
+	
 	return AAL_OK;
 }
 
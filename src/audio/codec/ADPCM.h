@@ -72,26 +72,31 @@ public:
 	
 private:
 	
-	void getSample(size_t channel_i, s8 nybble);
+	struct Channel {
+		s16 delta;
+		s16 samp1;
+		s16 samp2;
+		s16 coef1;
+		s16 coef2;
+	};
+	
+	//! Read the header and encoded samples of the next block
 	aalError getNextBlock();
 	
+	//! Decode all samples in the current block
+	void decodeBlock(s16 * output);
+	
 	PakFileHandle * stream;
 	ADPCMHeader * header;
 	u32 padding;
 	u32 shift;
-	u32 sample_i;
-	char * predictor;
-	s16 * delta;
-	s16 * samp1;
-	s16 * samp2;
-	s16 * coef1;
-	s16 * coef2;
-	s8 * nybble_l;
-	u32 nybble_c, nybble_i;
-	s8 nybble;
-	bool odd;
-	u8 cache_c, cache_i;
-	void * cache_l;
+	Channel channel[2];
+	u8 * nybble_l;
+	u32 nybble_c;
+	s16 * block_l; //!< Decoded samples of the current block
+	size_t block_c; //!< Size of one decoded block in bytes
+	size_t block_i; //!< Bytes of the current block that have already been read
+	bool decoded; //!< Has the current block been decoded into block_l?
 	size_t cursor;
 	
 };
@@ -59,12 +59,16 @@ OpenALBackend::OpenALBackend()
 	, effectSlot(AL_EFFECTSLOT_NULL)
 	#endif
 	, rolloffFactor(1.f)
+	, bufferCacheSize(0)
 {}
 
 OpenALBackend::~OpenALBackend() {
 	
 	sources.clear();
 	
+	arx_assert(unusedBuffers.size() == bufferCache.size());
+	trimBufferCache(0);
+	
 	if(context) {
 		
 		alcDestroyContext(context);
@@ -231,14 +235,6 @@ Source * OpenALBackend::createSource(SampleId sampleId, const Channel & channel)
 	
 	Sample * sample = _sample[s_id];
 	
-	OpenALSource * orig = NULL;
-	for(size_t i = 0; i < sources.size(); i++) {
-		if(sources[i] && sources[i]->getSample() == sample) {
-			orig = (OpenALSource*)sources[i];
-			break;
-		}
-	}
-	
 	OpenALSource * source = new OpenALSource(sample);
 	
 	size_t index = sources.add(source);
@@ -248,7 +244,7 @@ Source * OpenALBackend::createSource(SampleId sampleId, const Channel & channel)
 	}
 	
 	SourceId id = (index << 16) | s_id;
-	if(source->init(id, orig, channel)) {
+	if(source->init(id, this, channel)) {
 		sources.remove(index);
 		return NULL;
 	}
@@ -337,6 +333,70 @@ Backend::source_iterator OpenALBackend::deleteSource(source_iterator it) {
 	return (source_iterator)sources.remove((ResourceList<OpenALSource>::iterator)it);
 }
 
+ALuint OpenALBackend::acquireBuffer(const res::path & sample, bool mono, size_t & size) {
+	
+	BufferCache::iterator it = bufferCache.find(BufferKey(sample, mono));
+	if(it == bufferCache.end()) {
+		return 0;
+	}
+	
+	CachedBuffer & entry = it->second;
+	if(!entry.references) {
+		unusedBuffers.erase(entry.unused);
+	}
+	entry.references++;
+	
+	size = entry.size;
+	return entry.buffer;
+}
+
+void OpenALBackend::addBuffer(const res::path & sample, bool mono, ALuint buffer, size_t size) {
+	
+	CachedBuffer & entry = bufferCache[BufferKey(sample, mono)];
+	arx_assert(!entry.buffer);
+	
+	entry.buffer = buffer;
+	entry.size = size;
+	entry.references = 1;
+	bufferCacheSize += size;
+	
+}
+
+void OpenALBackend::releaseBuffer(const res::path & sample, bool mono) {
+	
+	BufferKey key(sample, mono);
+	BufferCache::iterator it = bufferCache.find(key);
+	arx_assert(it != bufferCache.end());
+	
+	CachedBuffer & entry = it->second;
+	arx_assert(entry.references > 0);
+	if(--entry.references) {
+		return;
+	}
+	
+	entry.unused = unusedBuffers.insert(unusedBuffers.end(), key);
+	
+	trimBufferCache(cache_limit_bytes);
+}
+
+void OpenALBackend::trimBufferCache(size_t limit) {
+	
+	while(bufferCacheSize > limit && !unusedBuffers.empty()) {
+		
+		BufferCache::iterator it = bufferCache.find(unusedBuffers.front());
+		arx_assert(it != bufferCache.end() && !it->second.references);
+		unusedBuffers.pop_front();
+		
+		LogDebug("evicting cached buffer for " << it->first.first);
+		alDeleteBuffers(1, &it->second.buffer);
+		AL_CHECK_ERROR_N("deleting buffer",)
+		
+		bufferCacheSize -= it->second.size;
+		bufferCache.erase(it);
+	}
+	
+}
+
 aalError OpenALBackend::setUnitFactor(float factor) {
 	
 #if ARX_HAVE_OPENAL_EFX
@@ -22,6 +22,9 @@
 
 #include "Configure.h"
 
+#include <list>
+#include <map>
+#include <utility>
 #include <vector>
 
 #include <al.h>
@@ -33,6 +36,7 @@
 #include "audio/AudioBackend.h"
 #include "audio/AudioTypes.h"
 #include "audio/AudioResource.h"
+#include "io/resource/ResourcePath.h"
 #include "math/Types.h"
 
 namespace audio {
@@ -71,6 +75,22 @@ public:
 	
 private:
 	
+	/*!
+	 * Get the cached buffer holding the decoded data for a sample and add a reference to it.
+	 * \param size Set to the size of the decoded data if the buffer is cached.
+	 * \return the buffer or 0 if there is no cached buffer for the sample.
+	 */
+	ALuint acquireBuffer(const res::path & sample, bool mono, size_t & size);
+	
+	//! Add a filled buffer to the cache - the caller holds the only reference
+	void addBuffer(const res::path & sample, bool mono, ALuint buffer, size_t size);
+	
+	//! Remove a reference to a buffer returned by acquireBuffer() or added by addBuffer()
+	void releaseBuffer(const res::path & sample, bool mono);
+	
+	//! Delete least recently used unreferenced buffers until the cache fits the limit
+	void trimBufferCache(size_t limit);
+	
 	ALCdevice * device;
 	ALCcontext * context;
 	
@@ -97,6 +117,21 @@ private:
 	
 	float rolloffFactor;
 	
+	typedef std::pair<res::path, bool> BufferKey;
+	
+	struct CachedBuffer {
+		ALuint buffer;
+		size_t size;
+		size_t references;
+		std::list<BufferKey>::iterator unused; // Only valid if there are no references
+	};
+	
+	typedef std::map<BufferKey, CachedBuffer> BufferCache;
+	
+	BufferCache bufferCache;
+	std::list<BufferKey> unusedBuffers; // Least recently used first
+	size_t bufferCacheSize;
+	
 	friend class OpenALSource;
 };
 
@@ -26,6 +26,7 @@
 #include <efx.h>
 #endif
 
+#include "audio/openal/OpenALBackend.h"
 #include "audio/openal/OpenALUtils.h"
 #include "audio/AudioGlobal.h"
 #include "audio/AudioResource.h"
@@ -97,7 +98,7 @@ OpenALSource::OpenALSource(Sample * _sample) :
 	streaming(false), loadCount(0), written(0), stream(NULL),
 	read(0),
 	source(0),
-	refcount(NULL),
+	m_backend(NULL), m_cached(false),
 	m_volume(1.f) {
 	for(size_t i = 0; i < NBUFFERS; i++) {
 		buffers[i] = 0;
@@ -132,19 +133,14 @@ OpenALSource::~OpenALSource() {
 				buffers[i] = 0;
 			}
 		}
-		arx_assert(!refcount);
 	} else {
-		if(buffers[0]) {
-			arx_assert(!refcount || *refcount > 0);
-			if(!refcount || !--*refcount) {
-				delete refcount, refcount = NULL;
-				TraceAL("deleting buffer " << buffers[0]);
-				alDeleteBuffers(1, &buffers[0]);
-				nbbuffers--;
-				AL_CHECK_ERROR_N("deleting buffer",)
-			}
-		} else {
-			arx_assert(!refcount);
+		if(m_cached) {
+			m_backend->releaseBuffer(sample->getName(), convertStereoToMono());
+		} else if(buffers[0]) {
+			TraceAL("deleting buffer " << buffers[0]);
+			alDeleteBuffers(1, &buffers[0]);
+			nbbuffers--;
+			AL_CHECK_ERROR_N("deleting buffer",)
 		}
 		for(size_t i = 1; i < NBUFFERS; i++) {
 			arx_assert(!buffers[i]);
@@ -161,33 +157,18 @@ bool OpenALSource::convertStereoToMono() {
 	return ((channel.flags & FLAG_ANY_3D_FX) && sample->getFormat().channels == 2);
 }
 
-aalError OpenALSource::init(SourceId _id, OpenALSource * inst, const Channel & _channel) {
+aalError OpenALSource::init(SourceId _id, OpenALBackend * backend, const Channel & _channel) {
 	
 	arx_assert(!source);
 	
 	id = _id;
+	m_backend = backend;
 	
 	channel = _channel;
 	if(channel.flags & FLAG_ANY_3D_FX) {
 		channel.flags &= ~FLAG_PAN;
 	}
 	
-	if(inst && !inst->streaming && convertStereoToMono() == inst->convertStereoToMono()) {
-		
-		arx_assert(inst->sample == sample);
-		
-		arx_assert(inst->buffers[0] != 0);
-		buffers[0] = inst->buffers[0];
-		bufferSizes[0] = inst->bufferSizes[0];
-		if(!inst->refcount) {
-			inst->refcount = new unsigned int;
-			*inst->refcount = 1;
-		}
-		refcount = inst->refcount;
-		(*refcount)++;
-		
-	}
-	
 	alGenSources(1, &source);
 	nbsources++;
 	alSourcei(source, AL_LOOPING, AL_FALSE);
@@ -195,7 +176,12 @@ aalError OpenALSource::init(SourceId _id, OpenALSource * inst, const Channel & _
 	
 	streaming = (sample->getLength() > (stream_limit_bytes * NBUFFERS));
 	
-	LogAL("init: length=" << sample->getLength() << " " << (streaming ? "streaming" : "static") << (buffers[0] ? " (copy)" : ""));
+	if(!streaming) {
+		buffers[0] = m_backend->acquireBuffer(sample->getName(), convertStereoToMono(), bufferSizes[0]);
+		m_cached = (buffers[0] != 0);
+	}
+	
+	LogAL("init: length=" << sample->getLength() << " " << (streaming ? "streaming" : "static") << (m_cached ? " (cached)" : ""));
 	
 	if(!streaming && !buffers[0]) {
 		stream = createStream(sample->getName());
@@ -212,6 +198,10 @@ aalError OpenALSource::init(SourceId _id, OpenALSource * inst, const Channel & _
 			return error;
 		}
 		arx_assert(!stream && !loadCount);
+		// The decoded sample is kept around for later sources until evicted
+		m_backend->addBuffer(sample->getName(), convertStereoToMono(), buffers[0], bufferSizes[0]);
+		m_cached = true;
+		nbbuffers--;
 	}
 	
 	setVolume(channel.volume);
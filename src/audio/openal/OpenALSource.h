@@ -32,6 +32,7 @@
 
 namespace audio {
 
+class OpenALBackend;
 class Sample;
 class Stream;
 
@@ -42,7 +43,7 @@ public:
 	explicit OpenALSource(Sample * sample);
 	~OpenALSource();
 	
-	aalError init(SourceId id, OpenALSource * instance, const Channel & channel);
+	aalError init(SourceId id, OpenALBackend * backend, const Channel & channel);
 	
 	aalError setPitch(float pitch);
 	aalError setPan(float pan);
@@ -116,7 +117,9 @@ private:
 
 	ALuint buffers[NBUFFERS];
 	size_t bufferSizes[NBUFFERS];
-	unsigned int * refcount; // reference count for shared buffers
+	
+	OpenALBackend * m_backend;
+	bool m_cached; // True if buffers[0] is owned by the backend's buffer cache
 	
 	float m_volume;
 	
@@ -1114,6 +1114,7 @@ void ArxGame::shutdownGame() {
 	KillInterfaceTextureContainers();
 	Menu2_Close();
 	DanaeClearLevel(2);
+	MCache_ClearAll();
 	TextureContainer::DeleteAll();
 	
 	delete ControlCinematique, ControlCinematique = NULL;
@@ -1132,7 +1133,6 @@ void ArxGame::shutdownGame() {
 	
 	//sound
 	ARX_SOUND_Release();
-	MCache_ClearAll();
 	
 	//pathfinding
 	ARX_PATH_ReleaseAllPath();
@@ -1143,6 +1143,7 @@ void ArxGame::shutdownGame() {
 	
 	//animations
 	EERIE_ANIMMANAGER_ClearAll();
+	EERIEDrawAnimQuatRelease();
 
 	//sprites
 	RenderBatcher::getInstance().reset();
@@ -1857,7 +1858,10 @@ void ArxGame::updateLevel() {
 		ARX_INTERACTIVE_Show_Hide_1st(entities.player(), 1);
 	}
 
+	EERIE_PATHFINDER_Update();
+
 	PrepareIOTreatZone();
+	ARX_INTERACTIVE_InvalidateGrid();
 	ARX_PHYSICS_Apply();
 
 	PrecalcIOLighting(ACTIVECAM->orgTrans.pos, ACTIVECAM->cdepth * 0.6f);
@@ -1942,7 +1946,8 @@ void ArxGame::renderLevel() {
 	arx_assert(pParticleManager);
 	pParticleManager->Render();
 	
-	ARX_PARTICLES_Update(&subj);
+	ARX_PARTICLES_Update();
+	ARX_PARTICLES_Render(&subj);
 	
 	GRenderer->SetFogColor(ulBKGColor);
 	GRenderer->SetRenderState(Renderer::DepthTest, true);
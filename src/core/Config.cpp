@@ -86,6 +86,7 @@ const bool
 	mouseLookToggle = true,
 	autoDescription = true,
 	forceToggle = false,
+	levelCache = false,
 	hudScale = false;
 
 ActionKey actions[NUM_ACTION_KEY] = {
@@ -241,6 +242,7 @@ const std::string
 	forceToggle = "forcetoggle",
 	migration = "migration",
 	quicksaveSlots = "quicksave_slots",
+	levelCache = "level_cache",
 	debugLevels = "debug";
 
 } // namespace Key
@@ -433,6 +435,7 @@ bool Config::save() {
 	writer.writeKey(Key::forceToggle, misc.forceToggle);
 	writer.writeKey(Key::migration, misc.migration);
 	writer.writeKey(Key::quicksaveSlots, misc.quicksaveSlots);
+	writer.writeKey(Key::levelCache, misc.levelCache);
 	writer.writeKey(Key::debugLevels, misc.debug);
 	
 	return writer.flush();
@@ -542,6 +545,7 @@ bool Config::init(const fs::path & file) {
 	misc.forceToggle = reader.getKey(Section::Misc, Key::forceToggle, Default::forceToggle);
 	misc.migration = (MigrationStatus)reader.getKey(Section::Misc, Key::migration, Default::migration);
 	misc.quicksaveSlots = std::max(reader.getKey(Section::Misc, Key::quicksaveSlots, Default::quicksaveSlots), 1);
+	misc.levelCache = reader.getKey(Section::Misc, Key::levelCache, Default::levelCache);
 	misc.debug = reader.getKey(Section::Misc, Key::debugLevels, Default::debugLevels);
 	
 	return loaded;
@@ -186,6 +186,8 @@ public:
 		
 		int quicksaveSlots;
 		
+		bool levelCache; //!< Keep decompressed level data in the user dir.
+		
 		std::string debug; //!< Logger debug levels.
 		
 	} misc;
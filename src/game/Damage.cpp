@@ -1245,9 +1245,11 @@ bool ARX_DAMAGES_TryToDoDamage(const Vec3f & pos, float dmg, float radius, Entit
 
 void CheckForIgnition(const Sphere & sphere, bool mode, long flag) {
 	
-	if(!(flag & 1))
-		for(size_t i = 0; i < MAX_LIGHTS; i++) {
-			EERIE_LIGHT * el = GLight[i];
+	if(!(flag & 1)) {
+		std::vector<size_t> lights;
+		EERIE_LIGHT_GetNear(sphere.origin, sphere.radius, lights);
+		for(size_t i = 0; i < lights.size(); i++) {
+			EERIE_LIGHT * el = GLight[lights[i]];
 
 			if(el == NULL)
 				continue;
@@ -1268,6 +1270,7 @@ void CheckForIgnition(const Sphere & sphere, bool mode, long flag) {
 
 			}
 		}
+	}
 
 	for(size_t i = 0; i < entities.size(); i++) {
 		const EntityHandle handle = EntityHandle(i);
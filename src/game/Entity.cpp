@@ -48,6 +48,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <cstring>
 
 #include "animation/Animation.h"
+#include "ai/PathFinderManager.h"
 #include "ai/Paths.h"
 
 #include "core/Core.h"
@@ -81,6 +82,7 @@ Entity::Entity(const res::path & classPath, EntityInstance instance)
 {
 	
 	m_index = entities.add(this);
+	ARX_INTERACTIVE_InvalidateGrid();
 	
 	ioflags = 0;
 	lastpos = Vec3f_ZERO;
@@ -106,6 +108,13 @@ Entity::Entity(const res::path & classPath, EntityInstance instance)
 	animBlend.m_active = false;
 	animBlend.lastanimtime = 0;
 	
+	animLod.level = 0;
+	animLod.skipped = 0;
+	animLod.valid = false;
+	animLod.pos = Vec3f_ZERO;
+	animLod.obj = NULL;
+	animLod.vertexCount = 0;
+	
 	std::memset(&bbox3D, 0, sizeof(EERIE_3D_BBOX)); // TODO use constructor
 	
 	bbox2D.min = Vec2f(-1.f, -1.f);
@@ -205,6 +214,8 @@ Entity::~Entity() {
 	
 	cleanReferences();
 	
+	EERIE_PATHFINDER_Remove(this);
+	
 	if((MasterCamera.exist & 1) && MasterCamera.io == this) {
 		MasterCamera.exist = 0;
 	}
@@ -226,6 +226,17 @@ struct AnimationBlendStatus {
 	unsigned long lastanimtime;
 };
 
+//! Animation level of detail, see EERIEDrawAnimQuatUpdateDeferred()
+struct AnimationLodStatus {
+	unsigned level; // The skeleton and mesh are updated every 2^level frames
+	unsigned skipped; // Number of frames since the last skeleton update
+	bool valid; // The mesh holds a pose that can be reused
+	Vec3f pos; // Position the mesh was last placed at
+	Anglef angle; // Angle of the last full update - the held pose is only moved, not rotated
+	const EERIE_3DOBJ * obj; // Mesh of the last full update, the entity's mesh may be replaced
+	size_t vertexCount; // Number of vertices of the mesh at the last full update
+};
+
 class Entity {
 	
 public:
@@ -252,6 +263,7 @@ public:
 	AnimLayer animlayer[MAX_ANIM_LAYERS];
 
 	AnimationBlendStatus animBlend;
+	AnimationLodStatus animLod;
 	
 	EERIE_3D_BBOX bbox3D;
 	EERIE_2D_BBOX bbox2D;
@@ -50,6 +50,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "game/Entity.h"
 #include "platform/Platform.h"
+#include "scene/Interactive.h"
 
 struct EntityManager::Impl {
 	
@@ -100,6 +101,8 @@ void EntityManager::clear() {
 	
 	entries.resize(1);
 	m_impl->m_minfree = 0;
+	
+	ARX_INTERACTIVE_InvalidateGrid();
 }
 
 EntityHandle EntityManager::getById(const std::string & idString) const {
@@ -165,4 +168,6 @@ void EntityManager::remove(size_t index) {
 	}
 	
 	entries[index] = NULL;
+	
+	ARX_INTERACTIVE_InvalidateGrid();
 }
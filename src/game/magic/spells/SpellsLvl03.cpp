@@ -404,10 +404,10 @@ void CreateFoodSpell::Update(float timeDelta) {
 		m_particles.m_parameters.m_spawnFlags = PARTICLE_CIRCULAR;
 		m_particles.m_parameters.m_gravity = Vec3f_ZERO;
 		
-		std::list<Particle *>::iterator i;
+		std::vector<Particle>::iterator i;
 		
 		for(i = m_particles.listParticle.begin(); i != m_particles.listParticle.end(); ++i) {
-			Particle * pP = *i;
+			Particle * pP = &*i;
 			
 			if(pP->isAlive()) {
 				pP->fColorEnd.a = 0;
@@ -488,12 +488,19 @@ static void drawDebugEntities() {
 		
 		if(closerThan(entity->pos, player.pos, DebugTextMaxDistance)) {
 			
+			std::string text = entity->idString();
+			if(entity->animLod.level) {
+				std::ostringstream oss;
+				oss << text << " [lod " << entity->animLod.level << ']';
+				text = oss.str();
+			}
+			
 			if(visible && entity->bbox2D.valid()) {
 				int x = (entity->bbox2D.min.x + entity->bbox2D.max.x) / 2;
 				int y = entity->bbox2D.min.y - hFontDebug->getLineHeight() - 2;
-				UNICODE_ARXDrawTextCenter(hFontDebug, Vec2f(x, y), entity->idString(), color);
+				UNICODE_ARXDrawTextCenter(hFontDebug, Vec2f(x, y), text, color);
 			} else {
-				drawTextAt(hFontDebug, entity->pos, entity->idString(), color);
+				drawTextAt(hFontDebug, entity->pos, text, color);
 			}
 			
 			if(entity->obj) {
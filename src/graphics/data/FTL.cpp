@@ -51,10 +51,13 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "graphics/data/FTL.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "graphics/data/FTLFormat.h"
 #include "graphics/data/TextureContainer.h"
@@ -70,6 +73,9 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "io/log/Logger.h"
 
 #include "platform/Platform.h"
+#include "platform/Thread.h"
+#include "platform/ThreadPool.h"
+#include "platform/profiler/Profiler.h"
 
 #include "scene/Object.h"
 
@@ -360,109 +366,169 @@ bool ARX_FTL_Save(const fs::path & file, const EERIE_3DOBJ * obj) {
 #endif // BUILD_EDIT_LOADSAVE
 
 // MESH cache structure definition & Globals
-struct MCACHE_DATA {
-	res::path name;
-	char * data;
-	size_t size;
-};
-static std::vector<MCACHE_DATA> meshCache;
+//! Parsed FTL meshes by file name, never handed out directly
+//! Only filled by ARX_FTL_Preload() and emptied once the level entities have been created.
+typedef boost::unordered_map<res::path, EERIE_3DOBJ *> MeshCache;
+static MeshCache meshCache;
 
-// Checks for Mesh file existence in cache
-static long MCache_Get(const res::path & file) {
+// Adds a parsed mesh to the cache, which takes ownership
+static void MCache_Push(const res::path & file, EERIE_3DOBJ * obj) {
 	
-	for(size_t i = 0; i < meshCache.size(); i++) {
-		if(meshCache[i].name == file) {
-			return i;
-		}
-	}
+	LogDebug(file << " #" << meshCache.size());
 	
-	return -1;
+	std::pair<MeshCache::iterator, bool> result = meshCache.insert(std::make_pair(file, obj));
+	if(!result.second) {
+		delete obj; // already cached
+	}
 }
 
-// Pushes a Mesh In Mesh Cache
-static bool MCache_Push(const res::path & file, char * data, size_t size) {
+void MCache_ClearAll() {
 	
-	if(MCache_Get(file) != -1) {
-		return false; // already cached
+	for(MeshCache::iterator it = meshCache.begin(); it != meshCache.end(); ++it) {
+		delete it->second;
 	}
 	
-	LogDebug(file << " #" << meshCache.size());
-	
-	MCACHE_DATA newMesh;
-	newMesh.size = size;
-	newMesh.data = data;
-	newMesh.name = file;
-	meshCache.push_back(newMesh);
-	
-	return true;
-}
-
-void MCache_ClearAll(){
-	for(std::vector<MCACHE_DATA>::iterator it = meshCache.begin(); it != meshCache.end(); ++it) {
-		free(it->data);
-	}
-
 	meshCache.clear();
 }
 
-// Retreives a Mesh File pointer from cache...
-static char * MCache_Pop(const res::path & file, size_t & size) {
+// Retreives a parsed mesh from the cache
+static const EERIE_3DOBJ * MCache_Get(const res::path & file) {
 	
-	long num = MCache_Get(file);
-	if(num == -1) {
+	MeshCache::const_iterator it = meshCache.find(file);
+	if(it == meshCache.end()) {
 		return NULL;
 	}
 	
-	size = meshCache[num].size;
-	return meshCache[num].data;
+	return it->second;
 }
 
-EERIE_3DOBJ * ARX_FTL_Load(const res::path & file) {
+// Decompress the contents of a FTL file, the returned buffer must be freed with free()
+static char * ARX_FTL_Decompress(const res::path & filename, const char * compressedData,
+                                 size_t compressedSize, size_t & size) {
 	
-	// Creates FTL file name
-	res::path filename = (res::path("game") / file).set_ext("ftl");
+	// Check if we have an uncompressed FTL file
+	if(compressedSize >= 3 && compressedData[0] == 'F' && compressedData[1] == 'T'
+	   && compressedData[2] == 'L') {
+		LogInfo << "Uncompressed FTL found: " << filename;
+		char * dat = (char *)malloc(compressedSize);
+		memcpy(dat, compressedData, compressedSize);
+		size = compressedSize;
+		return dat;
+	}
 	
-	// Checks for FTL file existence
-	PakFile * pf = resources->getFile(filename);
-	if(!pf) {
-		return NULL;
+	char * dat = blastMemAlloc(compressedData, compressedSize, size);
+	if(!dat) {
+		LogError << "ARX_FTL_Load: error decompressing " << filename;
 	}
 	
-	size_t compressedSize = 0;
-	char * compressedData = MCache_Pop(filename, compressedSize);
-	LogDebug("File name check " << filename);
+	return dat;
+}
+
+static res::path ARX_FTL_GetFilename(const res::path & file) {
+	return (res::path("game") / file).set_ext("ftl");
+}
+
+static EERIE_3DOBJ * ARX_FTL_Parse(const res::path & filename, const char * dat);
+
+namespace {
+
+//! Decompresses FTL files that have already been read from the resources
+class FTLDecompressTask : public ThreadPool::Task {
 	
-	bool NOrelease = true;
-	if(!compressedData) {
-		compressedData = pf->readAlloc();
-		compressedSize = pf->size();
-		NOrelease = MCache_Push(filename, compressedData, compressedSize) ? 1 : 0;
-	}
+public:
 	
-	if(!compressedData) {
-		LogError << "ARX_FTL_Load: error loading from PAK/cache " << filename;
-		return NULL;
+	struct File {
+		res::path filename;
+		const char * compressedData;
+		size_t compressedSize;
+		char * data;
+		size_t size;
+	};
+	
+	std::vector<File> files;
+	
+	void run(size_t index) {
+		File & file = files[index];
+		file.data = ARX_FTL_Decompress(file.filename, file.compressedData, file.compressedSize,
+		                               file.size);
 	}
 	
-	char * dat;
+};
+
+} // anonymous namespace
+
+void ARX_FTL_Preload(const std::vector<res::path> & files) {
+	
+	ARX_PROFILE_FUNC();
 	
-	// Check if we have an uncompressed FTL file
-	if(compressedData[0] == 'F' && compressedData[1] == 'T' && compressedData[2] == 'L') {
-		LogInfo << "Uncompressed FTL found: " << filename;
-		dat = (char *) malloc(compressedSize);
-		memcpy(dat, compressedData, compressedSize);
-	} else {
-		size_t allocsize; // The size of the data TODO size ignored
-		dat = blastMemAlloc(compressedData, compressedSize, allocsize);
-		if(!dat) {
-			LogError << "ARX_FTL_Load: error decompressing " << filename;
-			return NULL;
+	FTLDecompressTask task;
+	std::vector<char *> buffers;
+	
+	// Resources can only be read from the main thread
+	for(size_t i = 0; i < files.size(); i++) {
+		
+		FTLDecompressTask::File file;
+		file.filename = ARX_FTL_GetFilename(files[i]);
+		file.data = NULL;
+		file.size = 0;
+		
+		if(MCache_Get(file.filename)) {
+			continue;
+		}
+		
+		bool duplicate = false;
+		for(size_t j = 0; j < task.files.size(); j++) {
+			if(task.files[j].filename == file.filename) {
+				duplicate = true;
+				break;
+			}
+		}
+		if(duplicate) {
+			continue;
+		}
+		
+		PakFile * pf = resources->getFile(file.filename);
+		if(!pf) {
+			continue;
 		}
+		
+		file.compressedSize = pf->size();
+		file.compressedData = pf->data();
+		if(!file.compressedData) {
+			char * buffer = pf->readAlloc();
+			if(!buffer) {
+				continue;
+			}
+			buffers.push_back(buffer);
+			file.compressedData = buffer;
+		}
+		
+		task.files.push_back(file);
+	}
+	
+	if(!task.files.empty()) {
+		size_t threads = std::min(Thread::getProcessorCount(), unsigned(task.files.size())) - 1;
+		ThreadPool pool(threads, "FTLLoader");
+		pool.run(task, task.files.size());
+	}
+	
+	for(size_t i = 0; i < buffers.size(); i++) {
+		free(buffers[i]);
 	}
 	
-	if(!NOrelease) {
-		free(compressedData);
+	// Textures can only be loaded from the main thread
+	for(size_t i = 0; i < task.files.size(); i++) {
+		if(task.files[i].data) {
+			EERIE_3DOBJ * obj = ARX_FTL_Parse(task.files[i].filename, task.files[i].data);
+			free(task.files[i].data);
+			if(obj) {
+				MCache_Push(task.files[i].filename, obj);
+			}
+		}
 	}
+}
+
+static EERIE_3DOBJ * ARX_FTL_Parse(const res::path & filename, const char * dat) {
 	
 	size_t pos = 0; // The position within the data
 	
@@ -473,7 +539,6 @@ EERIE_3DOBJ * ARX_FTL_Load(const res::path & file) {
 	// Verify FTL file Signature
 	if(afph->ident[0] != 'F' || afph->ident[1] != 'T' || afph->ident[2] != 'L') {
 		LogError << "ARX_FTL_Load: wrong magic number in " << filename;
-		free(dat);
 		return NULL;
 	}
 	
@@ -481,7 +546,6 @@ EERIE_3DOBJ * ARX_FTL_Load(const res::path & file) {
 	if(afph->version != CURRENT_FTL_VERSION) {
 		LogError << "ARX_FTL_Load: wring version " << afph->version << ", expected "
 		         << CURRENT_FTL_VERSION << " in " << filename;
-		free(dat);
 		return NULL;
 	}
 	
@@ -493,7 +557,6 @@ EERIE_3DOBJ * ARX_FTL_Load(const res::path & file) {
 	afsh = reinterpret_cast<const ARX_FTL_SECONDARY_HEADER *>(dat + pos);
 	if(afsh->offset_3Ddata == -1) {
 		LogError << "ARX_FTL_Load: error loading data from " << filename;
-		free(dat);
 		return NULL;
 	}
 	pos = afsh->offset_3Ddata;
@@ -688,9 +751,6 @@ EERIE_3DOBJ * ARX_FTL_Load(const res::path & file) {
 		std::copy(begin, end, obj->cdata->springs.begin());
 	}
 	
-	// Free the loaded file memory
-	free(dat);
-	
 	EERIE_OBJECT_CenterObjectCoordinates(obj);
 	EERIE_CreateCedricData(obj);
 	// Now we can release our cool FTL file
@@ -705,3 +765,71 @@ EERIE_3DOBJ * ARX_FTL_Load(const res::path & file) {
 	
 	return obj;
 }
+
+/*!
+ * Create an instance of a cached mesh
+ * Eerie_Copy() does not copy the clothes and collision sphere data, so do that here.
+ */
+static EERIE_3DOBJ * ARX_FTL_Copy(const EERIE_3DOBJ * obj) {
+	
+	EERIE_3DOBJ * copy = Eerie_Copy(obj);
+	
+	if(obj->sdata) {
+		copy->sdata = new COLLISION_SPHERES_DATA(*obj->sdata);
+	}
+	
+	if(obj->cdata) {
+		copy->cdata = new CLOTHES_DATA();
+		copy->cdata->nb_cvert = obj->cdata->nb_cvert;
+		copy->cdata->springs = obj->cdata->springs;
+		copy->cdata->cvert = new CLOTHESVERTEX[obj->cdata->nb_cvert];
+		copy->cdata->backup = new CLOTHESVERTEX[obj->cdata->nb_cvert];
+		std::copy(obj->cdata->cvert, obj->cdata->cvert + obj->cdata->nb_cvert, copy->cdata->cvert);
+		std::copy(obj->cdata->backup, obj->cdata->backup + obj->cdata->nb_cvert,
+		          copy->cdata->backup);
+	}
+	
+	return copy;
+}
+
+EERIE_3DOBJ * ARX_FTL_Load(const res::path & file) {
+	
+	// Creates FTL file name
+	res::path filename = ARX_FTL_GetFilename(file);
+	
+	// Meshes preloaded for the current level only need to be copied
+	const EERIE_3DOBJ * cached = MCache_Get(filename);
+	LogDebug("File name check " << filename);
+	if(cached) {
+		return ARX_FTL_Copy(cached);
+	}
+	
+	// Checks for FTL file existence
+	PakFile * pf = resources->getFile(filename);
+	if(!pf) {
+		return NULL;
+	}
+	
+	const char * compressedData = pf->data();
+	char * compressedCopy = NULL;
+	if(!compressedData) {
+		compressedData = compressedCopy = pf->readAlloc();
+	}
+	if(!compressedData) {
+		LogError << "ARX_FTL_Load: error loading from PAK/cache " << filename;
+		return NULL;
+	}
+	
+	size_t size = 0;
+	char * dat = ARX_FTL_Decompress(filename, compressedData, pf->size(), size);
+	free(compressedCopy);
+	if(!dat) {
+		return NULL;
+	}
+	
+	// Not cached - the parsed mesh is handed out directly
+	EERIE_3DOBJ * obj = ARX_FTL_Parse(filename, dat);
+	free(dat);
+	
+	return obj;
+}
@@ -45,6 +45,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #ifndef ARX_GRAPHICS_DATA_FTL_H
 #define ARX_GRAPHICS_DATA_FTL_H
 
+#include <vector>
+
 #include "Configure.h"
 
 struct EERIE_3DOBJ;
@@ -64,9 +66,22 @@ bool ARX_FTL_Save(const fs::path & file, const EERIE_3DOBJ * obj);
 
 /*!
  * Load a FTL file
+ * Parsed meshes are cached, the returned object is a copy owned by the caller.
  */
 EERIE_3DOBJ * ARX_FTL_Load(const res::path & file);
 
+/*!
+ * Read, decompress and parse multiple FTL files, decompressing on all processors
+ * Later calls to ARX_FTL_Load() for these files only need to copy the cached meshes,
+ * until MCache_ClearAll() is called.
+ */
+void ARX_FTL_Preload(const std::vector<res::path> & files);
+
+/*!
+ * Release all cached meshes.
+ * Must be called once the preloaded meshes are no longer needed, and before the level
+ * textures are deleted.
+ */
 void MCache_ClearAll();
 
 #endif // ARX_GRAPHICS_DATA_FTL_H
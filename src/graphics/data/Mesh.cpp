@@ -80,7 +80,10 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "io/resource/ResourcePath.h"
 #include "io/fs/FileStream.h"
 #include "io/resource/PakReader.h"
+#include "io/resource/PakEntry.h"
 #include "io/fs/Filesystem.h"
+#include "io/fs/MappedFile.h"
+#include "io/fs/SystemPaths.h"
 #include "io/Blast.h"
 #include "io/Implode.h"
 #include "io/IO.h"
@@ -1365,19 +1368,106 @@ public:
 	
 };
 
+/*!
+ * Header of the files in the user dir that cache the decompressed scene data.
+ * The cache is only used if all fields match the values computed for the source file.
+ */
+struct FTS_CACHE_HEADER {
+	char magic[4];
+	u32 version;
+	u32 sourceSize;
+	u32 uncompressedSize;
+	u64 sourceTime; //!< Last write time of the source .fts file or its archive
+	u32 pad[2]; // Keep the scene data aligned
+};
+
+static const char FTS_CACHE_MAGIC[4] = { 'F', 'T', 'S', 'C' };
+static const u32 FTS_CACHE_VERSION = 1;
+
+static fs::path getFastSceneCachePath(const res::path & partial_path) {
+	
+	if(fs::paths.user.empty()) {
+		return fs::path();
+	}
+	
+	return fs::paths.user / "cache" / partial_path.string() / "fast.fts.cache";
+}
+
+/*!
+ * Load the decompressed scene data from the cache.
+ * The cache file is mapped into memory if possible and read into buffer otherwise.
+ * \return false if there is no cache file or it does not match the header
+ */
+static bool loadFastSceneCache(const fs::path & file, const FTS_CACHE_HEADER & header,
+                               fs::MappedFile & mapping, boost::scoped_array<char> & buffer,
+                               const char * & data, const char * & end) {
+	
+	const char * cache;
+	size_t size;
+	if(mapping.open(file)) {
+		cache = mapping.data(), size = mapping.size();
+	} else {
+		buffer.reset(fs::read_file(file, size));
+		if(!buffer) {
+			return false;
+		}
+		cache = buffer.get();
+	}
+	
+	if(size != sizeof(FTS_CACHE_HEADER) + header.uncompressedSize
+	   || memcmp(cache, &header, sizeof(FTS_CACHE_HEADER)) != 0) {
+		LogDebug("FTS: ignoring outdated cache " << file);
+		mapping.close();
+		buffer.reset();
+		return false;
+	}
+	
+	data = cache + sizeof(FTS_CACHE_HEADER), end = cache + size;
+	
+	return true;
+}
+
+static void saveFastSceneCache(const fs::path & file, const FTS_CACHE_HEADER & header,
+                               const char * data, size_t size) {
+	
+	if(!fs::create_directories(file.parent())) {
+		LogWarning << "FTS: could not create cache directory " << file.parent();
+		return;
+	}
+	
+	fs::ofstream ofs(file, fs::fstream::out | fs::fstream::binary | fs::fstream::trunc);
+	if(!ofs.is_open()
+	   || ofs.write(reinterpret_cast<const char *>(&header), sizeof(header)).fail()
+	   || ofs.write(data, size).fail()) {
+		LogWarning << "FTS: could not write cache " << file;
+		ofs.close();
+		fs::remove(file);
+		return;
+	}
+	
+	LogDebug("FTS: wrote cache " << file);
+}
+
 bool FastSceneLoad(const res::path & partial_path) {
 	
 	res::path file = "game" / partial_path / "fast.fts";
 	
 	const char * data = NULL, * end = NULL;
 	boost::scoped_array<char> bytes;
+	fs::MappedFile mapping;
 	
 	try {
 		
+		PakFile * pf = resources->getFile(file);
+		if(!pf) {
+			LogError << "FTS: could not find " << file;
+			return false;
+		}
+		
 		// Load the whole file
 		LogDebug("Loading " << file);
-		size_t size;
-		scoped_malloc<char> dat(resources->readAlloc(file, size));
+		size_t size = pf->size();
+		scoped_malloc<char> dat(pf->readAlloc());
 		data = dat.get(), end = dat.get() + size;
 		// TODO use new[] instead of malloc so we can use (boost::)unique_ptr
 		LogDebug("FTS: read " << size << " bytes");
@@ -1405,23 +1495,43 @@ bool FastSceneLoad(const res::path & partial_path) {
 		LoadLevelScreen();
 		
 		
-		// Decompress the actual scene data
-		size_t input_size = end - data;
-		LogDebug("FTS: decompressing " << input_size << " -> "
-		                               << uh->uncompressedsize);
-		bytes.reset(new char[uh->uncompressedsize]);
-		if(!bytes) {
-			LogError << "FTS: can't allocate buffer for uncompressed data";
-			return false;
-		}
-		size = blastMem(data, input_size, bytes.get(), uh->uncompressedsize);
-		data = bytes.get(), end = bytes.get() + size;
-		if(!size) {
-			LogError << "FTS: error decompressing scene data in " << file;
-			return false;
-		} else if(size != size_t(uh->uncompressedsize)) {
-			LogWarning << "FTS: unexpected decompressed size: " << size << " < "
-			           << uh->uncompressedsize << " in " << file;
+		// Use the scene data cached by an earlier load if the source file is unchanged
+		FTS_CACHE_HEADER header;
+		memset(&header, 0, sizeof(header));
+		std::copy(FTS_CACHE_MAGIC, FTS_CACHE_MAGIC + 4, header.magic);
+		header.version = FTS_CACHE_VERSION;
+		header.sourceSize = u32(size);
+		header.uncompressedSize = u32(uh->uncompressedsize);
+		header.sourceTime = u64(pf->time());
+		fs::path cachefile;
+		if(config.misc.levelCache && pf->time() != 0) {
+			cachefile = getFastSceneCachePath(partial_path);
+		}
+		if(!cachefile.empty()
+		   && loadFastSceneCache(cachefile, header, mapping, bytes, data, end)) {
+			LogDebug("FTS: using cache " << cachefile);
+		} else {
+			// Decompress the actual scene data
+			size_t input_size = end - data;
+			LogDebug("FTS: decompressing " << input_size << " -> "
+			                               << uh->uncompressedsize);
+			bytes.reset(new char[uh->uncompressedsize]);
+			if(!bytes) {
+				LogError << "FTS: can't allocate buffer for uncompressed data";
+				return false;
+			}
+			size = blastMem(data, input_size, bytes.get(), uh->uncompressedsize);
+			data = bytes.get(), end = bytes.get() + size;
+			if(!size) {
+				LogError << "FTS: error decompressing scene data in " << file;
+				return false;
+			} else if(size != size_t(uh->uncompressedsize)) {
+				LogWarning << "FTS: unexpected decompressed size: " << size << " < "
+				           << uh->uncompressedsize << " in " << file;
+			}
+			if(!cachefile.empty() && size == size_t(uh->uncompressedsize)) {
+				saveFastSceneCache(cachefile, header, data, size);
+			}
 		}
 		progressBarAdvance(3.f);
 		LoadLevelScreen();
@@ -85,7 +85,7 @@ public:
 	void Regen();
 	void Update(long);
 	
-	bool isAlive() {
+	bool isAlive() const {
 		return (m_age < m_timeToLive);
 	};
 	void Validate();
@@ -86,8 +86,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 extern Color ulBKGColor;
 
 static const size_t MAX_PARTICLES = 2200;
-static long ParticleCount = 0;
-static PARTICLE_DEF particle[MAX_PARTICLES];
+static size_t ParticleCount = 0;
+static PARTICLE_DEF particle[MAX_PARTICLES]; // Live particles are packed at the start
 
 static TextureContainer * blood_splat = NULL;
 static TextureContainer * bloodsplat[6];
@@ -104,7 +104,7 @@ static TextureContainer * explo[MAX_EXPLO]; // TextureContainer for animated exp
 long			NewSpell=0;
 
 long getParticleCount() {
-	return ParticleCount;
+	return long(ParticleCount);
 }
 
 void ARX_PARTICLES_Spawn_Lava_Burn(Vec3f pos, Entity * io) {
@@ -513,7 +513,7 @@ void ARX_PARTICLES_Spawn_Spark(const Vec3f & pos, float dmgs, long flags) {
 			return;
 		}
 		
-		pd->oldpos = pd->ov = pos + randomVec(-5.f, 5.f);
+		pd->pos = pd->ov = pos + randomVec(-5.f, 5.f);
 		pd->siz = 2.f;
 		pd->move = randomVec(-6.f, 6.f);
 		
@@ -830,7 +830,6 @@ void ARX_PARTICLES_FirstInit() {
 }
 
 void ARX_PARTICLES_ClearAll() {
-	memset(particle, 0, sizeof(PARTICLE_DEF) * MAX_PARTICLES);
 	ParticleCount = 0;
 }
 
@@ -840,32 +839,36 @@ PARTICLE_DEF * createParticle(bool allocateWhilePaused) {
 		return NULL;
 	}
 	
-	for(size_t i = 0; i < MAX_PARTICLES; i++) {
-		
-		PARTICLE_DEF * pd = &particle[i];
-		
-		if(pd->exist) {
-			continue;
-		}
-		
-		ParticleCount++;
-		pd->exist = true;
-		pd->timcreation = long(arxtime);
-		
-		pd->is2D = false;
-		pd->rgb = Color3f::white;
-		pd->tc = NULL;
-		pd->special = 0;
-		pd->source = NULL;
-		pd->delay = 0;
-		pd->zdec = false;
-		pd->move = Vec3f_ZERO;
-		pd->scale = Vec3f_ONE;
-		
-		return pd;
+	if(ParticleCount == MAX_PARTICLES) {
+		return NULL;
 	}
 	
-	return NULL;
+	PARTICLE_DEF * pd = &particle[ParticleCount++];
+	
+	// Slots are reused without clearing them in ARX_PARTICLES_ClearAll()
+	*pd = PARTICLE_DEF();
+	
+	pd->timcreation = long(arxtime);
+	
+	pd->rgb = Color3f::white;
+	pd->move = Vec3f_ZERO;
+	pd->scale = Vec3f_ONE;
+	pd->oldpos = Vec3f_ZERO;
+	pd->pos = Vec3f_ZERO;
+	
+	return pd;
+}
+
+/*!
+ * Remove a particle by moving the last live particle into its slot.
+ * Only particles after index have been moved, so iterating backwards visits each particle once.
+ */
+static void destroyParticle(size_t index) {
+	arx_assert(index < ParticleCount);
+	ParticleCount--;
+	if(index != ParticleCount) {
+		particle[index] = particle[ParticleCount];
+	}
 }
 
 void MagFX(const Vec3f & pos) {
@@ -1004,7 +1007,7 @@ void LaunchFireballBoom(const Vec3f & poss, float level, Vec3f * direction, Colo
 	
 }
 
-void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
+void ARX_PARTICLES_Update() {
 	
 	ARX_PROFILE_FUNC();
 	
@@ -1016,21 +1019,15 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 		return;
 	}
 	
-	Vec3f in;
-	Vec3f inn;
-	TexturedVertex out;
-	
 	unsigned long tim = (unsigned long)arxtime;
 	
-	long pcc = ParticleCount;
-	
-	for(size_t i = 0; i < MAX_PARTICLES && pcc > 0; i++) {
-
+	// Iterate backwards so that removed particles can be replaced with the last one
+	// Particles spawned during the update are only processed next frame
+	for(size_t i = ParticleCount; i-- > 0; ) {
+		
 		PARTICLE_DEF * part = &particle[i];
-		if(!part->exist) {
-			continue;
-		}
-
+		part->fade = 0.f;
+		
 		long framediff = part->timcreation + part->tolive - tim;
 		long framediff2 = tim - part->timcreation;
 		
@@ -1058,8 +1055,7 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 			EERIE_BKG_INFO * bkgData = getFastBackgroundData(part->ov.x, part->ov.z);
 
 			if(!bkgData || !bkgData->treat) {
-				part->exist = false;
-				ParticleCount--;
+				destroyParticle(i);
 				continue;
 			}
 		}
@@ -1083,8 +1079,7 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 				framediff = part->tolive;
 				
 			} else {
-				part->exist = false;
-				ParticleCount--;
+				destroyParticle(i);
 				continue;
 			}
 		}
@@ -1100,7 +1095,7 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 				pd->timcreation = tim;
 				pd->zdec = false;
 				pd->special |= SUBSTRACT;
-				pd->ov = part->oldpos;
+				pd->ov = part->pos;
 				pd->tc = tzupouf;
 				pd->scale *= 4.f;
 				part->scale = glm::abs(part->scale);
@@ -1112,18 +1107,19 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 		
 		float val = (part->tolive - framediff) * 0.01f;
 		
+		Vec3f in;
 		if((part->special & FOLLOW_SOURCE) && part->sourceionum != EntityHandle::Invalid
 				&& entities[part->sourceionum]) {
-			inn = in = *part->source;
+			in = *part->source;
 		} else if((part->special & FOLLOW_SOURCE2) && part->sourceionum != EntityHandle::Invalid
 							&& entities[part->sourceionum]) {
-			inn = in = *part->source + part->move * val;
+			in = *part->source + part->move * val;
 		} else {
-			inn = in = part->ov + part->move * val;
+			in = part->ov + part->move * val;
 		}
 		
 		if(part->special & GRAVITY) {
-			in.y = inn.y = inn.y + 1.47f * val * val;
+			in.y = in.y + 1.47f * val * val;
 		}
 		
 		float fd = float(framediff2) / float(part->tolive);
@@ -1141,38 +1137,6 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 			
 			Sphere sp;
 			sp.origin = in;
-			EE_RTP(inn, &out);
-			if(out.rhw < 0 || out.p.z > cam->cdepth * fZFogEnd) {
-				continue;
-			}
-			
-			if(part->special & PARTICLE_SPARK) {
-				
-				Vec3f vect = part->oldpos - in;
-				vect = glm::normalize(vect);
-				TexturedVertex tv[3];
-				tv[0].color = part->rgb.toRGB();
-				tv[1].color = Color(102, 102, 102, 255).toRGBA();
-				tv[2].color = Color(0, 0, 0, 255).toRGBA();
-				tv[0].p = out.p;
-				tv[0].rhw = out.rhw;
-				Vec3f temp;
-				temp = in + Vec3f(rnd() * 0.5f, 0.8f, rnd() * 0.5f);
-				EE_RTP(temp, &tv[1]);
-				temp = in + vect * part->fparam;
-				
-				EE_RTP(temp, &tv[2]);
-				
-				RenderMaterial mat;
-				mat.setBlendType(RenderMaterial::Additive);
-				RenderBatcher::getInstance().add(mat, tv);
-				
-				if(!arxtime.is_paused()) {
-					part->oldpos = in;
-				}
-				
-				continue;
-			}
 			
 			if(part->special & SPLAT_GROUND) {
 				float siz = part->siz + part->scale.x * fd;
@@ -1182,8 +1146,7 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 						Color3f rgb = part->rgb;
 						SpawnGroundSplat(sp, rgb, 0);
 					}
-					part->exist = false;
-					ParticleCount--;
+					destroyParticle(i);
 					continue;
 				}
 			}
@@ -1196,28 +1159,22 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 						Color3f rgb = part->rgb * 0.5f;
 						SpawnGroundSplat(sp, rgb, 2);
 					}
-					part->exist = false;
-					ParticleCount--;
+					destroyParticle(i);
 					continue;
 				}
 			}
 			
 		}
 		
-		if((part->special & DISSIPATING) && out.p.z < 0.05f) {
-			out.p.z *= 20.f;
-			r *= out.p.z;
+		if(!arxtime.is_paused()) {
+			part->oldpos = part->pos;
 		}
+		part->pos = in;
 		
 		if(r <= 0.f) {
-			pcc--;
 			continue;
 		}
 		
-		if(!arxtime.is_paused()) {
-			part->oldpos = in;
-		}
-		
 		if(part->special & PARTICLE_GOLDRAIN) {
 			float v = (rnd() - 0.5f) * 0.2f;
 			if(part->rgb.r + v <= 1.f && part->rgb.r + v > 0.f
@@ -1227,6 +1184,75 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 			}
 		}
 		
+		part->fade = r;
+	}
+}
+
+void ARX_PARTICLES_Render(EERIE_CAMERA * cam) {
+	
+	ARX_PROFILE_FUNC();
+	
+	if(!ACTIVEBKG) {
+		return;
+	}
+	
+	unsigned long tim = (unsigned long)arxtime;
+	
+	for(size_t i = 0; i < ParticleCount; i++) {
+		
+		const PARTICLE_DEF * part = &particle[i];
+		
+		// Particles that were not updated this frame are not drawn
+		float r = part->fade;
+		if(r <= 0.f) {
+			continue;
+		}
+		
+		long framediff2 = tim - part->timcreation;
+		float fd = float(framediff2) / float(part->tolive);
+		const Vec3f & in = part->pos;
+		
+		if(!part->is2D) {
+			
+			TexturedVertex out;
+			EE_RTP(in, &out);
+			if(out.rhw < 0 || out.p.z > cam->cdepth * fZFogEnd) {
+				continue;
+			}
+			
+			if(part->special & PARTICLE_SPARK) {
+				
+				Vec3f vect = part->oldpos - in;
+				vect = glm::normalize(vect);
+				TexturedVertex tv[3];
+				tv[0].color = part->rgb.toRGB();
+				tv[1].color = Color(102, 102, 102, 255).toRGBA();
+				tv[2].color = Color(0, 0, 0, 255).toRGBA();
+				tv[0].p = out.p;
+				tv[0].rhw = out.rhw;
+				Vec3f temp;
+				temp = in + Vec3f(rnd() * 0.5f, 0.8f, rnd() * 0.5f);
+				EE_RTP(temp, &tv[1]);
+				temp = in + vect * part->fparam;
+				
+				EE_RTP(temp, &tv[2]);
+				
+				RenderMaterial mat;
+				mat.setBlendType(RenderMaterial::Additive);
+				RenderBatcher::getInstance().add(mat, tv);
+				
+				continue;
+			}
+			
+			if((part->special & DISSIPATING) && out.p.z < 0.05f) {
+				out.p.z *= 20.f;
+				r *= out.p.z;
+				if(r <= 0.f) {
+					continue;
+				}
+			}
+		}
+		
 		Color color = (part->rgb * r).to<u8>();
 		if(player.m_improve) {
 			color.g = 0;
@@ -1284,7 +1310,6 @@ void ARX_PARTICLES_Update(EERIE_CAMERA * cam)  {
 			
 		}
 		
-		pcc--;
 	}
 }
 
@@ -105,12 +105,13 @@ struct POLYBOOM {
 };
 
 struct PARTICLE_DEF {
-	bool exist;
 	bool is2D;
 	Vec3f ov;
 	Vec3f move;
 	Vec3f scale;
-	Vec3f oldpos;
+	Vec3f oldpos; // Position in the previous frame
+	Vec3f pos; // Position in the current frame
+	float fade; // Opacity in the current frame, not drawn if <= 0
 	float siz;
 	bool zdec;
 	long timcreation;
@@ -158,7 +159,10 @@ long getParticleCount();
 
 void ARX_PARTICLES_FirstInit();
 void ARX_PARTICLES_ClearAll();
-void ARX_PARTICLES_Update(EERIE_CAMERA * cam);
+//! Advance the particle simulation for the current frame
+void ARX_PARTICLES_Update();
+//! Draw the particles as simulated by the last call to ARX_PARTICLES_Update()
+void ARX_PARTICLES_Render(EERIE_CAMERA * cam);
 void ARX_PARTICLES_Spawn_Blood(const Vec3f & pos, float dmgs, EntityHandle source);
 void ARX_PARTICLES_Spawn_Blood2(const Vec3f & pos, float dmgs, Color col, Entity * io);
 void ARX_PARTICLES_Spawn_Lava_Burn(Vec3f pos, Entity * io = NULL);
@@ -82,13 +82,13 @@ void ParticleManager::Update(long _lTime) {
 
 	while(i != listParticleSystem.end()) {
 		ParticleSystem * p = *i;
-		++i;
 
 		if(!p->IsAlive()) {
 			delete p;
-			listParticleSystem.remove(p);
+			i = listParticleSystem.erase(i);
 		} else {
 			p->Update(_lTime);
+			++i;
 		}
 	}
 }
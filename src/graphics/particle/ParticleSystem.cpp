@@ -46,7 +46,6 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <cstdio>
 #include <cstring>
 
-#include <boost/foreach.hpp>
 #include <glm/gtc/random.hpp>
 
 #include "core/GameTime.h"
@@ -108,14 +107,7 @@ ParticleSystem::ParticleSystem() {
 	m_parameters.m_blendMode = RenderMaterial::Additive;
 }
 
-ParticleSystem::~ParticleSystem() {
-	
-	BOOST_FOREACH(Particle * p, listParticle) {
-		delete p;
-	}
-	
-	listParticle.clear();
-}
+ParticleSystem::~ParticleSystem() { }
 
 void ParticleSystem::SetPos(const Vec3f & pos) {
 	
@@ -255,30 +247,31 @@ void ParticleSystem::Update(long _lTime) {
 	
 	iParticleNbAlive = 0;
 	
-	std::list<Particle *>::iterator i;
-	for(i = listParticle.begin(); i != listParticle.end(); ) {
-		Particle * pP = *i;
+	// Particles are stored by value - compact the live ones to the front in one pass
+	size_t count = 0;
+	for(size_t i = 0; i < listParticle.size(); i++) {
+		Particle & p = listParticle[i];
 		
-		if(pP->isAlive()) {
-			pP->Update(_lTime);
-			pP->p3Velocity += m_parameters.m_gravity * fTimeSec;
-			iParticleNbAlive ++;
-			++i;
+		if(p.isAlive()) {
+			p.Update(_lTime);
+			p.p3Velocity += m_parameters.m_gravity * fTimeSec;
+		} else if(iParticleNbAlive >= m_parameters.m_nbMax) {
+			continue;
 		} else {
-			if(iParticleNbAlive >= m_parameters.m_nbMax) {
-				delete pP;
-				i = listParticle.erase(i);
-			} else {
-				pP->Regen();
-				SetParticleParams(pP);
-				pP->Validate();
-				pP->Update(0);
-				iParticleNbAlive++;
-				++i;
-			}
+			p.Regen();
+			SetParticleParams(&p);
+			p.Validate();
+			p.Update(0);
 		}
+		
+		iParticleNbAlive++;
+		if(count != i) {
+			listParticle[count] = p;
+		}
+		count++;
 	}
-
+	listParticle.resize(count);
+	
 	// création de particules en fct de la fréquence
 	if(iParticleNbAlive < m_parameters.m_nbMax) {
 		size_t t = m_parameters.m_nbMax - iParticleNbAlive;
@@ -287,12 +280,13 @@ void ParticleSystem::Update(long _lTime) {
 			t = std::min(size_t(m_storedTime.update(fTimeSec * m_parameters.m_freq)), t);
 		}
 		
+		listParticle.reserve(listParticle.size() + t);
 		for(size_t iNb = 0; iNb < t; iNb++) {
-			Particle * pP  = new Particle();
+			listParticle.push_back(Particle());
+			Particle * pP = &listParticle.back();
 			SetParticleParams(pP);
 			pP->Validate();
 			pP->Update(0);
-			listParticle.insert(listParticle.end(), pP);
 			iParticleNbAlive++;
 		}
 	}
@@ -302,6 +296,24 @@ void ParticleSystem::Update(long _lTime) {
 	}
 }
 
+void ParticleSystem::UpdateTexture(Particle & p) {
+	
+	if(iNbTex <= 0 || iTexTime == 0 || p.iTexTime <= iTexTime) {
+		return;
+	}
+	
+	p.iTexTime -= iTexTime;
+	p.iTexNum++;
+	
+	if(p.iTexNum > iNbTex - 1) {
+		if(bTexLoop) {
+			p.iTexNum = 0;
+		} else {
+			p.iTexNum = iNbTex - 1;
+		}
+	}
+}
+
 void ParticleSystem::Render() {
 	
 	RenderMaterial mat;
@@ -310,10 +322,10 @@ void ParticleSystem::Render() {
 
 	int inumtex = 0;
 
-	std::list<Particle *>::iterator i;
+	std::vector<Particle>::iterator i;
 
 	for(i = listParticle.begin(); i != listParticle.end(); ++i) {
-		Particle * p = *i;
+		Particle * p = &*i;
 
 		if(p->isAlive()) {
 			if(m_parameters.m_flash > 0) {
@@ -322,6 +334,8 @@ void ParticleSystem::Render() {
 			}
 
 			if(iNbTex > 0) {
+				// Texture animation advances per drawn frame
+				UpdateTexture(*p);
 				inumtex = p->iTexNum;
 
 				if(iTexTime == 0) {
@@ -331,21 +345,6 @@ void ParticleSystem::Render() {
 					if(inumtex >= iNbTex) {
 						inumtex = iNbTex - 1;
 					}
-				} else {
-					if(p->iTexTime > iTexTime) {
-						p->iTexTime -= iTexTime;
-						p->iTexNum++;
-
-						if(p->iTexNum > iNbTex - 1) {
-							if(bTexLoop) {
-								p->iTexNum = 0;
-							} else {
-								p->iTexNum = iNbTex - 1;
-							}
-						}
-
-						inumtex = p->iTexNum;
-					}
 				}
 			}
 			
@@ -44,11 +44,12 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #ifndef ARX_GRAPHICS_PARTICLE_PARTICLESYSTEM_H
 #define ARX_GRAPHICS_PARTICLE_PARTICLESYSTEM_H
 
-#include <list>
+#include <vector>
 
 #include "graphics/BaseGraphicsTypes.h"
 #include "graphics/Renderer.h"
 #include "graphics/Draw.h"
+#include "graphics/particle/Particle.h"
 #include "graphics/particle/ParticleParams.h"
 #include "math/Types.h"
 #include "math/Vector.h"
@@ -56,7 +57,6 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "platform/Alignment.h"
 #include "platform/Flags.h"
  
-class Particle;
 class ParticleParams;
 class TextureContainer;
 
@@ -64,7 +64,7 @@ class ParticleSystem {
 	
 public:
 	
-	std::list<Particle *> listParticle;
+	std::vector<Particle> listParticle;
 	
 	// these are used for the particles it creates
 	ParticleParams m_parameters;
@@ -99,6 +99,9 @@ private:
 	
 	void SetParticleParams(Particle * particle);
 	
+	//! Advance the texture animation frame of a live particle
+	void UpdateTexture(Particle & particle);
+	
 	void SetTexture(const char *, int, int);
 	
 public:
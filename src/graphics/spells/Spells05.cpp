@@ -115,10 +115,10 @@ static void LaunchPoisonExplosion(const Vec3f & aePos) {
 	pPS->SetPos(aePos);
 	pPS->Update(0);
 
-	std::list<Particle *>::iterator i;
+	std::vector<Particle>::iterator i;
 
 	for(i = pPS->listParticle.begin(); i != pPS->listParticle.end(); ++i) {
-		Particle * pP = *i;
+		Particle * pP = &*i;
 
 		if(pP->isAlive()) {
 			pP->p3Velocity = glm::clamp(pP->p3Velocity, Vec3f(0, -100, 0), Vec3f(0, 100, 0));
@@ -263,6 +263,12 @@ void ShowInfoText() {
 	miscBox.add("Mouse", Vec2i(DANAEMouse));
 	miscBox.add("Pathfind queue", EERIE_PATHFINDER_Get_Queued_Number());
 	miscBox.add("Pathfind status", (PATHFINDER_WORKING ? "Working" : "Idled"));
+	{
+		long hits, misses;
+		EERIE_PATHFINDER_Get_Cache_Stats(hits, misses);
+		miscBox.add("Pathfind cache hits", hits);
+		miscBox.add("Pathfind cache misses", misses);
+	}
 	miscBox.print();
 	
 	{
@@ -175,7 +175,11 @@ void MiniMap::loadOffsets(PakReader *pakRes) {
 	char * dat = new char[fileSize + 1];
 	dat[fileSize] = '\0';
 	
-	file->read(dat);
+	if(!file->read(dat)) {
+		LogError << "Error reading " << iniMiniOffsets;
+		delete[] dat;
+		return;
+	}
 	
 	size_t pos = 0;
 	
@@ -45,7 +45,7 @@
 #include "io/log/Logger.h"
 
 #define MAXBITS 13              /* maximum code length */
-#define MAXWIN 4096             /* maximum window size */
+#define MAXWIN BLAST_WINDOW_SIZE /* maximum window size */
 
 namespace {
 
@@ -61,6 +61,7 @@ struct state {
 	void * inhow;               /* opaque information passed to infun() */
 	const unsigned char * in;   /* next input location */
 	unsigned left;              /* available input at in */
+	size_t intotal;             /* total input provided by infun() */
 	int bitbuf;                 /* bit buffer */
 	int bitcnt;                 /* number of bits in bit buffer */
 	
@@ -69,8 +70,15 @@ struct state {
 	void * outhow;              /* opaque information passed to outfun() */
 	unsigned next;              /* index of next write location in out[] */
 	int first;                  /* true to check distances (for first 4K) */
+	size_t outtotal;            /* total output passed to outfun() */
 	unsigned char out[MAXWIN];  /* output buffer and sliding window */
 	
+	/* checkpoint state */
+	blast_checkpoint checkfun;  /* checkpoint function provided by user */
+	void * checkhow;            /* opaque information passed to checkfun() */
+	int lit;                    /* true if literals are coded */
+	int dict;                   /* log2(dictionary size) - 6 */
+	
 };
 
 /*
@@ -94,6 +102,7 @@ static int bits(state * s, int need) {
 		if(s->left == 0) {
 			s->left = s->infun(s->inhow, &(s->in));
 			if (s->left == 0) throw blast_truncated_error(); /* out of input */
+			s->intotal += s->left;
 		}
 		val |= (int)(*(s->in)++) << s->bitcnt;          /* load eight bits */
 		s->left--;
@@ -178,6 +187,7 @@ static int decode(state * s, huffman * h) {
 		if(s->left == 0) {
 			s->left = s->infun(s->inhow, &(s->in));
 			if (s->left == 0) throw blast_truncated_error(); /* out of input */
+			s->intotal += s->left;
 		}
 		bitbuf = *(s->in)++;
 		s->left--;
@@ -256,6 +266,74 @@ static int construct(huffman * h, const unsigned char * rep, int n) {
 	return left;
 }
 
+namespace {
+
+/* bit lengths of literal codes */
+const unsigned char litlen[] = {
+	11, 124, 8, 7, 28, 7, 188, 13, 76, 4, 10, 8, 12, 10, 12, 10, 8, 23, 8,
+	9, 7, 6, 7, 8, 7, 6, 55, 8, 23, 24, 12, 11, 7, 9, 11, 12, 6, 7, 22, 5,
+	7, 24, 6, 11, 9, 6, 7, 22, 7, 11, 38, 7, 9, 8, 25, 11, 8, 11, 9, 12,
+	8, 12, 5, 38, 5, 38, 5, 11, 7, 5, 6, 21, 6, 10, 53, 8, 7, 24, 10, 27,
+	44, 253, 253, 253, 252, 252, 252, 13, 12, 45, 12, 45, 12, 61, 12, 45,
+	44, 173
+};
+/* bit lengths of length codes 0..15 */
+const unsigned char lenlen[] = {2, 35, 36, 53, 38, 23};
+/* bit lengths of distance codes 0..63 */
+const unsigned char distlen[] = {2, 20, 53, 230, 247, 151, 248};
+
+/* decoding tables, built during static initialization so that blast() is reentrant */
+struct decode_tables {
+	
+	short litcnt[MAXBITS+1], litsym[256];        /* litcode memory */
+	short lencnt[MAXBITS+1], lensym[16];         /* lencode memory */
+	short distcnt[MAXBITS+1], distsym[64];       /* distcode memory */
+	huffman litcode;
+	huffman lencode;
+	huffman distcode;
+	
+	decode_tables() {
+		litcode.count = litcnt, litcode.symbol = litsym;
+		lencode.count = lencnt, lencode.symbol = lensym;
+		distcode.count = distcnt, distcode.symbol = distsym;
+		construct(&litcode, litlen, sizeof(litlen));
+		construct(&lencode, lenlen, sizeof(lenlen));
+		construct(&distcode, distlen, sizeof(distlen));
+	}
+	
+} tables;
+
+} // anonymous namespace
+
+/*
+ * Write out the full output window and pass the decompression state to
+ * checkfun() if requested.  len and dist are the remaining length and the
+ * distance of the current copy.  Returns false if outfun() failed.
+ */
+static bool flush(state * s, int len, int dist) {
+	
+	if(s->outfun(s->outhow, s->out, MAXWIN)) return false;
+	s->next = 0;
+	s->first = 0;
+	s->outtotal += MAXWIN;
+	
+	if(s->checkfun) {
+		BlastCheckpoint checkpoint;
+		checkpoint.inOffset = s->intotal - s->left;
+		checkpoint.outOffset = s->outtotal;
+		checkpoint.bitbuf = s->bitbuf;
+		checkpoint.bitcnt = s->bitcnt;
+		checkpoint.lit = s->lit;
+		checkpoint.dict = s->dict;
+		checkpoint.len = len;
+		checkpoint.dist = dist;
+		memcpy(checkpoint.window, s->out, MAXWIN);
+		s->checkfun(s->checkhow, checkpoint);
+	}
+	
+	return true;
+}
+
 /*
  * Decode PKWare Compression Library stream.
  *
@@ -294,7 +372,7 @@ static int construct(huffman * h, const unsigned char * rep, int n) {
  *   ignoring whether the length is greater than the distance or not implements
  *   this correctly.
  */
-static BlastResult blastDecompress(state * s) {
+static BlastResult blastDecompress(state * s, const BlastCheckpoint * resume) {
 	
 	int lit;            /* true if literals are coded */
 	int dict;           /* log2(dictionary size) - 6 */
@@ -303,26 +381,9 @@ static BlastResult blastDecompress(state * s) {
 	int dist;           /* distance for copy */
 	int copy;           /* copy counter */
 	unsigned char * from, *to;   /* copy pointers */
-	static int virgin = 1;                              /* build tables once */
-	static short litcnt[MAXBITS+1], litsym[256];        /* litcode memory */
-	static short lencnt[MAXBITS+1], lensym[16];         /* lencode memory */
-	static short distcnt[MAXBITS+1], distsym[64];       /* distcode memory */
-	static huffman litcode = {litcnt, litsym};   /* length code */
-	static huffman lencode = {lencnt, lensym};   /* length code */
-	static huffman distcode = {distcnt, distsym};/* distance code */
-	/* bit lengths of literal codes */
-	static const unsigned char litlen[] = {
-		11, 124, 8, 7, 28, 7, 188, 13, 76, 4, 10, 8, 12, 10, 12, 10, 8, 23, 8,
-		9, 7, 6, 7, 8, 7, 6, 55, 8, 23, 24, 12, 11, 7, 9, 11, 12, 6, 7, 22, 5,
-		7, 24, 6, 11, 9, 6, 7, 22, 7, 11, 38, 7, 9, 8, 25, 11, 8, 11, 9, 12,
-		8, 12, 5, 38, 5, 38, 5, 11, 7, 5, 6, 21, 6, 10, 53, 8, 7, 24, 10, 27,
-		44, 253, 253, 253, 252, 252, 252, 13, 12, 45, 12, 45, 12, 61, 12, 45,
-		44, 173
-	};
-	/* bit lengths of length codes 0..15 */
-	static const unsigned char lenlen[] = {2, 35, 36, 53, 38, 23};
-	/* bit lengths of distance codes 0..63 */
-	static const unsigned char distlen[] = {2, 20, 53, 230, 247, 151, 248};
+	huffman * litcode = &tables.litcode;    /* literal code */
+	huffman * lencode = &tables.lencode;    /* length code */
+	huffman * distcode = &tables.distcode;  /* distance code */
 	static const short base[16] = {     /* base for length codes */
 		3, 2, 4, 5, 6, 7, 8, 9, 10, 12, 16, 24, 40, 72, 136, 264
 	};
@@ -330,75 +391,81 @@ static BlastResult blastDecompress(state * s) {
 		0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8
 	};
 	
-	/* set up decoding tables (once--might not be thread-safe) */
-	if(virgin) {
-		construct(&litcode, litlen, sizeof(litlen));
-		construct(&lencode, lenlen, sizeof(lenlen));
-		construct(&distcode, distlen, sizeof(distlen));
-		virgin = 0;
+	if(resume) {
+		/* continue where the checkpoint was taken, possibly in the middle of a copy */
+		lit = resume->lit;
+		dict = resume->dict;
+		len = resume->len;
+		dist = resume->dist;
+	} else {
+		/* read header */
+		lit = bits(s, 8);
+		if (lit > 1) return BLAST_INVALID_LITERAL_FLAG;
+		dict = bits(s, 8);
+		if (dict < 4 || dict > 6) return BLAST_INVALID_DIC_SIZE;
+		len = 0;
+		dist = 0;
 	}
-	
-	/* read header */
-	lit = bits(s, 8);
-	if (lit > 1) return BLAST_INVALID_LITERAL_FLAG;
-	dict = bits(s, 8);
-	if (dict < 4 || dict > 6) return BLAST_INVALID_DIC_SIZE;
+	s->lit = lit;
+	s->dict = dict;
 	
 	/* decode literals and length/distance pairs */
 	do {
-		if(bits(s, 1)) {
+		if(len == 0) {
+			
+			if(!bits(s, 1)) {
+				/* get literal and write it */
+				symbol = lit ? decode(s, litcode) : bits(s, 8);
+				s->out[s->next++] = symbol;
+				if(s->next == MAXWIN && !flush(s, 0, 0)) return BLAST_OUTPUT_ERROR;
+				continue;
+			}
+			
 			/* get length */
-			symbol = decode(s, &lencode);
+			symbol = decode(s, lencode);
 			len = base[symbol] + bits(s, extra[symbol]);
 			if (len == 519) break;              /* end code */
 			
 			/* get distance */
 			symbol = len == 2 ? 2 : dict;
-			dist = decode(s, &distcode) << symbol;
+			dist = decode(s, distcode) << symbol;
 			dist += bits(s, symbol);
 			dist++;
 			if (s->first && dist > (int)s->next)
 				return BLAST_INVALID_OFFSET;
 			
-			/* copy length bytes from distance bytes back */
-			do {
-				to = s->out + s->next;
-				from = to - dist;
-				copy = MAXWIN;
-				if ((int)s->next < dist) {
-					from += copy;
-					copy = dist;
-				}
-				copy -= s->next;
-				if (copy > len) copy = len;
-				len -= copy;
-				s->next += copy;
-				do {
-					*to++ = *from++;
-				} while(--copy);
-				if(s->next == MAXWIN) {
-					if(s->outfun(s->outhow, s->out, s->next)) return BLAST_OUTPUT_ERROR;
-					s->next = 0;
-					s->first = 0;
-				}
-			} while(len != 0);
-			
-		} else {
-			/* get literal and write it */
-			symbol = lit ? decode(s, &litcode) : bits(s, 8);
-			s->out[s->next++] = symbol;
-			if(s->next == MAXWIN) {
-				if(s->outfun(s->outhow, s->out, s->next)) return BLAST_OUTPUT_ERROR;
-				s->next = 0;
-				s->first = 0;
-			}
 		}
+		
+		/* copy length bytes from distance bytes back */
+		do {
+			to = s->out + s->next;
+			from = to - dist;
+			copy = MAXWIN;
+			if ((int)s->next < dist) {
+				from += copy;
+				copy = dist;
+			}
+			copy -= s->next;
+			if (copy > len) copy = len;
+			len -= copy;
+			s->next += copy;
+			do {
+				*to++ = *from++;
+			} while(--copy);
+			if(s->next == MAXWIN && !flush(s, len, dist)) return BLAST_OUTPUT_ERROR;
+		} while(len != 0);
+		
 	} while(1);
 	
 	return BLAST_SUCCESS;
 }
 
 BlastResult blast(blast_in infun, void *inhow, blast_out outfun, void *outhow) {
+	return blast(infun, inhow, outfun, outhow, NULL, NULL, NULL);
+}
+
+BlastResult blast(blast_in infun, void *inhow, blast_out outfun, void *outhow,
+                  const BlastCheckpoint * resume, blast_checkpoint checkfun, void * checkhow) {
 	
 	state s;
 	
@@ -406,18 +473,27 @@ BlastResult blast(blast_in infun, void *inhow, blast_out outfun, void *outhow) {
 	s.infun = infun;
 	s.inhow = inhow;
 	s.left = 0;
-	s.bitbuf = 0;
-	s.bitcnt = 0;
+	s.intotal = resume ? resume->inOffset : 0;
+	s.bitbuf = resume ? resume->bitbuf : 0;
+	s.bitcnt = resume ? resume->bitcnt : 0;
 	
 	// initialize output state
 	s.outfun = outfun;
 	s.outhow = outhow;
 	s.next = 0;
-	s.first = 1;
+	s.first = resume ? 0 : 1;
+	s.outtotal = resume ? resume->outOffset : 0;
+	if(resume) {
+		memcpy(s.out, resume->window, MAXWIN);
+	}
+	
+	// initialize checkpoint state
+	s.checkfun = checkfun;
+	s.checkhow = checkhow;
 	
 	BlastResult err;
 	try {
-		err = blastDecompress(&s);
+		err = blastDecompress(&s, resume);
 	} catch(const blast_truncated_error &) {
 		err = BLAST_TRUNCATED_INPUT;
 	}
@@ -92,6 +92,45 @@ enum BlastResult {
  */
 BlastResult blast(blast_in infun, void *inhow, blast_out outfun, void *outhow);
 
+//! Size of the sliding window - outfun() is called whenever this much output is available
+const size_t BLAST_WINDOW_SIZE = 4096;
+
+/*!
+ * Decompression state right after the output window has been flushed.
+ * Decompression can be resumed from this point without decoding the preceding data.
+ */
+struct BlastCheckpoint {
+	
+	size_t inOffset;  //!< Number of input bytes consumed
+	size_t outOffset; //!< Number of output bytes produced, a multiple of BLAST_WINDOW_SIZE
+	
+	int bitbuf;
+	int bitcnt;
+	int lit;
+	int dict;
+	int len;
+	int dist;
+	
+	unsigned char window[BLAST_WINDOW_SIZE]; //!< The last BLAST_WINDOW_SIZE output bytes
+	
+};
+
+/*!
+ * Called after each flush of the output window with the current decompression state.
+ */
+typedef void (*blast_checkpoint)(void *how, const BlastCheckpoint & checkpoint);
+
+/*!
+ * Like blast(), but resume decompression from a previously recorded checkpoint.
+ * 
+ * \param resume If not NULL, decompression continues from this state and infun() must
+ *               provide input starting at resume->inOffset.
+ * \param checkfun If not NULL, called with the decompression state each time
+ *                 BLAST_WINDOW_SIZE bytes have been passed to outfun().
+ */
+BlastResult blast(blast_in infun, void *inhow, blast_out outfun, void *outhow,
+                  const BlastCheckpoint * resume, blast_checkpoint checkfun, void * checkhow);
+
 // Convenience implementations.
 
 struct BlastMemOutBuffer {
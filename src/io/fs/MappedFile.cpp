@@ -0,0 +1,118 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/fs/MappedFile.h"
+
+#include <limits>
+
+#include "Configure.h"
+
+#include "io/fs/FilePath.h"
+#include "io/fs/Filesystem.h"
+#include "platform/Platform.h"
+
+#if ARX_PLATFORM == ARX_PLATFORM_WIN32
+#include <windows.h>
+#elif ARX_HAVE_MMAP && ARX_HAVE_OPEN && ARX_HAVE_CLOSE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define ARX_MAPPEDFILE_POSIX 1
+#endif
+
+namespace fs {
+
+bool MappedFile::open(const path & p) {
+	
+	close();
+	
+	u64 size = file_size(p);
+	if(size == u64(-1) || size == 0 || size > u64(std::numeric_limits<size_t>::max())) {
+		return false;
+	}
+	
+#if ARX_PLATFORM == ARX_PLATFORM_WIN32
+	
+	HANDLE file = CreateFileA(p.string().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+	                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	
+	HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if(!mapping) {
+		return false;
+	}
+	
+	// The view keeps the mapping alive
+	void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(!view) {
+		return false;
+	}
+	
+	m_data = static_cast<const char *>(view);
+	m_size = size_t(size);
+	
+	return true;
+	
+#elif defined(ARX_MAPPEDFILE_POSIX)
+	
+	int fd = ::open(p.string().c_str(), O_RDONLY);
+	if(fd < 0) {
+		return false;
+	}
+	
+	// The mapping stays valid after the file descriptor is closed
+	void * addr = mmap(NULL, size_t(size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(addr == MAP_FAILED) {
+		return false;
+	}
+	
+	m_data = static_cast<const char *>(addr);
+	m_size = size_t(size);
+	
+	return true;
+	
+#else
+	
+	return false;
+	
+#endif
+}
+
+void MappedFile::close() {
+	
+	if(!m_data) {
+		return;
+	}
+	
+#if ARX_PLATFORM == ARX_PLATFORM_WIN32
+	UnmapViewOfFile(m_data);
+#elif defined(ARX_MAPPEDFILE_POSIX)
+	munmap(const_cast<char *>(m_data), m_size);
+#endif
+	
+	m_data = NULL;
+	m_size = 0;
+}
+
+} // namespace fs
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_IO_FS_MAPPEDFILE_H
+#define ARX_IO_FS_MAPPEDFILE_H
+
+#include <stddef.h>
+
+#include <boost/noncopyable.hpp>
+
+namespace fs {
+
+class path;
+
+/*!
+ * Read-only memory mapping of a whole file.
+ */
+class MappedFile : private boost::noncopyable {
+	
+public:
+	
+	MappedFile() : m_data(NULL), m_size(0) { }
+	~MappedFile() { close(); }
+	
+	/*!
+	 * Map the given file into memory.
+	 * \return false if the file could not be mapped or memory mapping is not supported.
+	 */
+	bool open(const path & p);
+	
+	void close();
+	
+	bool is_open() const { return m_data != NULL; }
+	
+	//! Contents of the file, valid until close() is called.
+	const char * data() const { return m_data; }
+	
+	size_t size() const { return m_size; }
+	
+private:
+	
+	const char * m_data;
+	size_t m_size;
+	
+};
+
+} // namespace fs
+
+#endif // ARX_IO_FS_MAPPEDFILE_H
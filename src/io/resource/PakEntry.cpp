@@ -34,7 +34,10 @@ char * PakFile::readAlloc() const {
 	
 	char * buffer = (char*)malloc(size());
 	
-	read(buffer);
+	if(!read(buffer)) {
+		free(buffer);
+		return NULL;
+	}
 	
 	return buffer;
 }
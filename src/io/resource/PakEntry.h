@@ -20,6 +20,7 @@
 #ifndef ARX_IO_RESOURCE_PAKENTRY_H
 #define ARX_IO_RESOURCE_PAKENTRY_H
 
+#include <ctime>
 #include <string>
 #include <map>
 
@@ -35,11 +36,14 @@ private:
 	
 	size_t _size;
 	
+	std::time_t _time;
+	
 	PakFile * _alternative;
 	
 protected:
 	
-	explicit inline PakFile(size_t size) :  _size(size), _alternative(NULL) { }
+	explicit inline PakFile(size_t size, std::time_t time)
+		: _size(size), _time(time), _alternative(NULL) { }
 	
 	virtual ~PakFile();
 	
@@ -49,11 +53,30 @@ protected:
 public:
 	
 	inline size_t size() const { return _size; }
+	
+	/*!
+	 * \return the last write time of the file, or of the archive containing it.
+	 *         0 if the time is not known.
+	 */
+	inline std::time_t time() const { return _time; }
 	inline PakFile * alternative() const { return _alternative; }
 	
-	virtual void read(void * buf) const = 0;
+	/*!
+	 * Read the whole file into a buffer of size() bytes.
+	 * \return false if the file could not be read or decompressed.
+	 */
+	virtual bool read(void * buf) const = 0;
+	
+	//! \return a malloc'ed buffer with the file contents, or NULL on error
 	char * readAlloc() const;
 	
+	/*!
+	 * Get the contents of the file without copying them.
+	 * \return a pointer to size() bytes that stay valid as long as the file exists, or NULL
+	 *         if the file is not stored uncompressed in a memory-mapped archive.
+	 */
+	virtual const char * data() const { return NULL; }
+	
 	virtual PakFileHandle * open() const = 0;
 	
 };
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <iomanip>
 #include <ios>
+#include <vector>
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/foreach.hpp>
@@ -33,6 +34,7 @@
 #include "io/fs/FilePath.h"
 #include "io/fs/Filesystem.h"
 #include "io/fs/FileStream.h"
+#include "io/fs/MappedFile.h"
 
 #include "util/String.h"
 
@@ -40,6 +42,9 @@ namespace {
 
 const size_t PAK_READ_BUF_SIZE = 1024;
 
+// Distance between the decompression checkpoints kept for partially read compressed files
+const size_t PAK_CHECKPOINT_INTERVAL = 16 * BLAST_WINDOW_SIZE;
+
 static PakReader::ReleaseType guessReleaseType(u32 first_bytes) {
 	switch(first_bytes) {
 		case 0x46515641:
@@ -75,15 +80,22 @@ static void pakDecrypt(char * fat, size_t fat_size, PakReader::ReleaseType keyId
 /*! Uncompressed file in a .pak file archive. */
 class UncompressedFile : public PakFile {
 	
-	std::istream & archive;
+	std::istream * archive; // NULL if the archive is memory-mapped
+	const char * mapped; // Contents of the file if the archive is memory-mapped
 	size_t offset;
 	
 public:
 	
-	explicit UncompressedFile(std::istream * _archive, size_t _offset, size_t size)
-		: PakFile(size), archive(*_archive), offset(_offset) { }
+	explicit UncompressedFile(std::istream * _archive, size_t _offset, size_t size,
+	                          std::time_t time)
+		: PakFile(size, time), archive(_archive), mapped(NULL), offset(_offset) { }
+	
+	explicit UncompressedFile(const char * _mapped, size_t size, std::time_t time)
+		: PakFile(size, time), archive(NULL), mapped(_mapped), offset(0) { }
 	
-	void read(void * buf) const;
+	bool read(void * buf) const;
+	
+	const char * data() const { return mapped; }
 	
 	PakFileHandle * open() const;
 	
@@ -111,16 +123,23 @@ public:
 	
 };
 
-void UncompressedFile::read(void * buf) const {
+bool UncompressedFile::read(void * buf) const {
+	
+	if(mapped) {
+		memcpy(buf, mapped, size());
+		return true;
+	}
+	
+	archive->seekg(offset);
 	
-	archive.seekg(offset);
+	fs::read(*archive, buf, size());
 	
-	fs::read(archive, buf, size());
+	arx_assert(!archive->fail());
+	arx_assert(size_t(archive->gcount()) == size());
 	
-	arx_assert(!archive.fail());
-	arx_assert(size_t(archive.gcount()) == size());
+	archive->clear();
 	
-	archive.clear();
+	return true;
 }
 
 PakFileHandle * UncompressedFile::open() const {
@@ -133,18 +152,24 @@ size_t UncompressedFileHandle::read(void * buf, size_t size) {
 		return 0;
 	}
 	
-	file.archive.seekg(file.offset + offset);
-	
 	if(file.size() < offset + size) {
 		size = (offset > file.size()) ? 0 : (file.size() - offset);
 	}
 	
-	fs::read(file.archive, buf, size);
+	if(file.mapped) {
+		memcpy(buf, file.mapped + offset, size);
+		offset += size;
+		return size;
+	}
+	
+	file.archive->seekg(file.offset + offset);
 	
-	size_t nread = file.archive.gcount();
+	fs::read(*file.archive, buf, size);
+	
+	size_t nread = file.archive->gcount();
 	offset += nread;
 	
-	file.archive.clear();
+	file.archive->clear();
 	
 	return nread;
 }
@@ -175,17 +200,28 @@ size_t UncompressedFileHandle::tell() {
 /*! Compressed file in a .pak file archive. */
 class CompressedFile : public PakFile {
 	
-	std::ifstream & archive;
+	std::ifstream * archive; // NULL if the archive is memory-mapped
+	const char * mapped; // Compressed data if the archive is memory-mapped
 	size_t offset;
 	size_t storedSize;
 	
+	// Decompression states every PAK_CHECKPOINT_INTERVAL bytes, sorted by output offset.
+	// Filled when the file is first read through a handle.
+	mutable std::vector<BlastCheckpoint> checkpoints;
+	
 public:
 	
 	explicit CompressedFile(std::ifstream * _archive, size_t _offset, size_t size,
-	                        size_t _storedSize)
-		: PakFile(size), archive(*_archive), offset(_offset), storedSize(_storedSize) { }
+	                        size_t _storedSize, std::time_t time)
+		: PakFile(size, time), archive(_archive), mapped(NULL), offset(_offset),
+		  storedSize(_storedSize) { }
+	
+	explicit CompressedFile(const char * _mapped, size_t size, size_t _storedSize,
+	                        std::time_t time)
+		: PakFile(size, time), archive(NULL), mapped(_mapped), offset(0),
+		  storedSize(_storedSize) { }
 	
-	void read(void * buf) const;
+	bool read(void * buf) const;
 	
 	PakFileHandle * open() const;
 	
@@ -198,10 +234,17 @@ class CompressedFileHandle : public PakFileHandle {
 	const CompressedFile & file;
 	size_t offset;
 	
+	// Last decompression state reached by this handle, used to continue sequential reads
+	BlastCheckpoint checkpoint;
+	
+	static void recordCheckpoint(void * Param, const BlastCheckpoint & checkpoint);
+	
 public:
 	
 	explicit CompressedFileHandle(const CompressedFile * _file)
-		: file(*_file), offset(0) { }
+		: file(*_file), offset(0) {
+		checkpoint.outOffset = 0;
+	}
 	
 	size_t read(void * buf, size_t size);
 	
@@ -237,23 +280,36 @@ size_t blastInFile(void * Param, const unsigned char ** buf) {
 	return fs::read(p->file, p->readbuf, count).gcount();
 }
 
-void CompressedFile::read(void * buf) const {
+bool CompressedFile::read(void * buf) const {
 	
-	archive.seekg(offset);
+	if(mapped) {
+		size_t outSize = blastMem(mapped, storedSize, reinterpret_cast<char *>(buf), size());
+		if(outSize != size()) {
+			LogError << "Blast error: got " << outSize << " bytes, expected " << size();
+			return false;
+		}
+		return true;
+	}
 	
-	BlastFileInBuffer in(&archive, storedSize);
+	archive->seekg(offset);
+	
+	BlastFileInBuffer in(archive, storedSize);
 	BlastMemOutBuffer out(reinterpret_cast<char *>(buf), size());
 	
 	int r = blast(blastInFile, &in, blastOutMem, &out);
 	if(r) {
 		LogError << "Blast error " << r << " outSize=" << size();
+		archive->clear();
+		return false;
 	}
 	
-	arx_assert(!archive.fail());
+	arx_assert(!archive->fail());
 	arx_assert(in.remaining == 0);
 	arx_assert(out.size == 0);
 	
-	archive.clear();
+	archive->clear();
+	
+	return true;
 }
 
 PakFileHandle * CompressedFile::open() const {
@@ -301,24 +357,46 @@ int blastOutMemOffset(void * Param, unsigned char * buf, size_t len) {
 	return 0;
 }
 
+static bool isBeforeCheckpoint(size_t offset, const BlastCheckpoint & checkpoint) {
+	return offset < checkpoint.outOffset;
+}
+
+void CompressedFileHandle::recordCheckpoint(void * Param, const BlastCheckpoint & checkpoint) {
+	
+	CompressedFileHandle * p = (CompressedFileHandle *)Param;
+	
+	p->checkpoint = checkpoint;
+	
+	std::vector<BlastCheckpoint> & checkpoints = p->file.checkpoints;
+	if(checkpoint.outOffset % PAK_CHECKPOINT_INTERVAL == 0
+	   && (checkpoints.empty() || checkpoints.back().outOffset < checkpoint.outOffset)) {
+		checkpoints.push_back(checkpoint);
+	}
+}
+
 size_t CompressedFileHandle::read(void * buf, size_t size) {
 	
 	if(offset >= file.size()) {
 		return 0;
 	}
 	
-	if(size < file.size() || offset != 0) {
-		LogWarning << "Partially reading a compressed file - inefficent: size=" << size
-		           << " offset=" << offset << " total=" << file.size();
+	// Resume decompression from the closest known state before the requested data
+	const BlastCheckpoint * resume = NULL;
+	std::vector<BlastCheckpoint>::const_iterator it;
+	it = std::upper_bound(file.checkpoints.begin(), file.checkpoints.end(), offset,
+	                      isBeforeCheckpoint);
+	if(it != file.checkpoints.begin()) {
+		resume = &*(it - 1);
+	}
+	if(checkpoint.outOffset != 0 && checkpoint.outOffset <= offset
+	   && (!resume || checkpoint.outOffset > resume->outOffset)) {
+		resume = &checkpoint;
 	}
 	
-	file.archive.seekg(file.offset);
-	
-	BlastFileInBuffer in(&file.archive, file.storedSize);
 	BlastMemOutBufferOffset out;
 	
 	out.buf = reinterpret_cast<char *>(buf);
-	out.currentOffset = 0;
+	out.currentOffset = resume ? resume->outOffset : 0;
 	out.startOffset = offset;
 	out.endOffset = std::min(offset + size, file.size());
 	
@@ -326,8 +404,18 @@ size_t CompressedFileHandle::read(void * buf, size_t size) {
 		return 0;
 	}
 	
-	// TODO this is really inefficient
-	int r = ::blast(blastInFile, &in, blastOutMemOffset, &out);
+	size_t inOffset = resume ? resume->inOffset : 0;
+	
+	int r;
+	if(file.mapped) {
+		BlastMemInBuffer in(file.mapped + inOffset, file.storedSize - inOffset);
+		r = ::blast(blastInMem, &in, blastOutMemOffset, &out, resume, recordCheckpoint, this);
+	} else {
+		file.archive->seekg(file.offset + inOffset);
+		BlastFileInBuffer in(file.archive, file.storedSize - inOffset);
+		r = ::blast(blastInFile, &in, blastOutMemOffset, &out, resume, recordCheckpoint, this);
+		file.archive->clear();
+	}
 	if(r && (r != 1 || (size == file.size() && offset == 0))) {
 		LogError << "PakReader::fRead: blast error " << r << " outSize=" << file.size();
 		return 0;
@@ -337,8 +425,6 @@ size_t CompressedFileHandle::read(void * buf, size_t size) {
 	
 	offset += size;
 	
-	file.archive.clear();
-	
 	return size;
 }
 
@@ -372,9 +458,10 @@ class PlainFile : public PakFile {
 	
 public:
 	
-	PlainFile(const fs::path & _path, size_t size) : PakFile(size), path(_path) { }
+	PlainFile(const fs::path & _path, size_t size, std::time_t time)
+		: PakFile(size, time), path(_path) { }
 	
-	void read(void * buf) const;
+	bool read(void * buf) const;
 	
 	PakFileHandle * open() const;
 	
@@ -401,7 +488,7 @@ public:
 	
 };
 
-void PlainFile::read(void * buf) const {
+bool PlainFile::read(void * buf) const {
 	
 	fs::ifstream ifs(path, fs::fstream::in | fs::fstream::binary);
 	arx_assert(ifs.is_open());
@@ -410,6 +497,8 @@ void PlainFile::read(void * buf) const {
 	
 	arx_assert(!ifs.fail());
 	arx_assert(size_t(ifs.gcount()) == size());
+	
+	return !ifs.fail();
 }
 
 PakFileHandle * PlainFile::open() const {
@@ -449,6 +538,8 @@ bool PakReader::addArchive(const fs::path & pakfile) {
 		return false;
 	}
 	
+	std::time_t time = fs::last_write_time(pakfile);
+	
 	// Read fat location and size.
 	u32 fat_offset;
 	u32 fat_size;
@@ -491,7 +582,26 @@ bool PakReader::addArchive(const fs::path & pakfile) {
 	
 	char * pos = fat;
 	
-	paks.push_back(ifs);
+	/*
+	 * Read files directly from a memory mapping of the archive if possible.
+	 * Whole archives are mapped, which would take up a large part of the address space
+	 * on 32-bit systems - use normal reads there.
+	 */
+	fs::MappedFile * mapping = NULL;
+	if(sizeof(void *) >= 8) {
+		mapping = new fs::MappedFile;
+		if(!mapping->open(pakfile)) {
+			delete mapping;
+			mapping = NULL;
+		}
+	}
+	if(mapping) {
+		mappings.push_back(mapping);
+		delete ifs;
+		ifs = NULL;
+	} else {
+		paks.push_back(ifs);
+	}
 	
 	while(fat_size) {
 		
@@ -531,12 +641,25 @@ bool PakReader::addArchive(const fs::path & pakfile) {
 				goto error;
 			}
 			
+			if(mapping && (offset > mapping->size() || size > mapping->size() - offset)) {
+				LogError << pakfile << ": file " << filename << " extends past the end of the archive";
+				goto error;
+			}
+			
 			const u32 PAK_FILE_COMPRESSED = 1;
 			PakFile * file;
 			if((flags & PAK_FILE_COMPRESSED) && size != 0) {
-				file = new CompressedFile(ifs, offset, uncompressedSize, size);
+				if(mapping) {
+					file = new CompressedFile(mapping->data() + offset, uncompressedSize, size, time);
+				} else {
+					file = new CompressedFile(ifs, offset, uncompressedSize, size, time);
+				}
 			} else {
-				file = new UncompressedFile(ifs, offset, size);
+				if(mapping) {
+					file = new UncompressedFile(mapping->data() + offset, size, time);
+				} else {
+					file = new UncompressedFile(ifs, offset, size, time);
+				}
 			}
 			
 			dir->addFile(std::string(filename, len), file);
@@ -567,6 +690,12 @@ void PakReader::clear() {
 	BOOST_FOREACH(std::istream * is, paks) {
 		delete is;
 	}
+	paks.clear();
+	
+	BOOST_FOREACH(fs::MappedFile * mapping, mappings) {
+		delete mapping;
+	}
+	mappings.clear();
 }
 
 bool PakReader::read(const res::path & name, void * buf) {
@@ -576,9 +705,7 @@ bool PakReader::read(const res::path & name, void * buf) {
 		return false;
 	}
 	
-	f->read(buf);
-	
-	return true;
+	return f->read(buf);
 }
 
 char * PakReader::readAlloc(const res::path & name, size_t & sizeRead) {
@@ -656,7 +783,7 @@ bool PakReader::addFile(PakDirectory * dir, const fs::path & path,
 		return false;
 	}
 	
-	dir->addFile(name, new PlainFile(path, size));
+	dir->addFile(name, new PlainFile(path, size, fs::last_write_time(path)));
 	return true;
 }
 
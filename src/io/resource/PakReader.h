@@ -29,7 +29,7 @@
 #include "io/resource/ResourcePath.h"
 #include "platform/Flags.h"
 
-namespace fs { class path; }
+namespace fs { class path; class MappedFile; }
 
 enum Whence {
 	SeekSet,
@@ -101,6 +101,7 @@ private:
 	
 	ReleaseFlags release;
 	std::vector<std::istream *> paks;
+	std::vector<fs::MappedFile *> mappings;
 	
 	bool addFiles(PakDirectory * dir, const fs::path & path);
 	bool addFile(PakDirectory * dir, const fs::path & path, const std::string & name);
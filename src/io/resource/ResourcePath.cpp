@@ -22,6 +22,8 @@
 #include <cctype>
 #include <algorithm>
 
+#include <boost/functional/hash.hpp>
+
 #include "platform/Platform.h"
 
 namespace res {
@@ -358,4 +360,8 @@ path path::load(const std::string & str) {
 	return copy;
 }
 
+size_t hash_value(const path & path) {
+	return boost::hash<std::string>()(path.string());
+}
+
 } // namespace fs
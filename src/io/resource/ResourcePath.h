@@ -251,6 +251,9 @@ inline std::ostream & operator<<(std::ostream & strm, const path & path) {
 	return strm << '"' << path.string() << '"';
 }
 
+//! Hash function for boost::unordered_* containers
+size_t hash_value(const path & path);
+
 } // namespace fs
 
 #endif // ARX_IO_RESOURCE_RESOURCEPATH_H
@@ -46,6 +46,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "physics/Collisions.h"
 
+#include "ai/PathFinderManager.h"
 #include "core/GameTime.h"
 #include "core/Core.h"
 #include "game/Damage.h"
@@ -298,9 +299,15 @@ bool IsCollidingIO(Entity * io,Entity * ioo) {
 
 void PushIO_ON_Top(Entity * ioo, float ydec) {
 	
-	if(ydec != 0.f)
-	for(size_t i = 0; i < entities.size(); i++) {
-		const EntityHandle handle = EntityHandle(i);
+	if(ydec == 0.f)
+		return;
+	
+	NearbyList<EntityHandle> nearBuffer;
+	std::vector<EntityHandle> & nearEntities = nearBuffer.get();
+	ARX_INTERACTIVE_GetNear(ioo->pos, 450.f, nearEntities);
+	
+	for(size_t i = 0; i < nearEntities.size(); i++) {
+		const EntityHandle handle = nearEntities[i];
 		Entity * io = entities[handle];
 
 		if(io
@@ -543,22 +550,35 @@ float CheckAnythingInCylinder(const Cylinder & cyl, Entity * ioo, long flags) {
 	if(!(flags & CFLAG_NO_INTERCOL)) {
 		Entity * io;
 		long FULL_TEST = 0;
-		long AMOUNT = TREATZONE_CUR;
-
+		
 		if(ioo
 			&& (ioo->ioflags & IO_NPC)
 			&& (ioo->_npcdata->pathfind.flags & PATHFIND_ALWAYS))
 		{
 			FULL_TEST = 1;
-			AMOUNT = entities.size();
 		}
-
-		for(long i = 0; i < AMOUNT; i++) {
-			const EntityHandle handle = EntityHandle(i);
+		
+		NearbyList<EntityHandle> nearEntitiesBuffer;
+		NearbyList<size_t> nearTreatZoneBuffer;
+		std::vector<EntityHandle> & nearEntities = nearEntitiesBuffer.get();
+		std::vector<size_t> & nearTreatZone = nearTreatZoneBuffer.get();
+		size_t AMOUNT;
+		if(FULL_TEST) {
+			ARX_INTERACTIVE_GetNear(cyl.origin, 1000.f, nearEntities);
+			AMOUNT = nearEntities.size();
+		} else {
+			TREATZONE_GetNear(cyl.origin, 1000.f, nearTreatZone);
+			AMOUNT = nearTreatZone.size();
+		}
+		
+		for(size_t n = 0; n < AMOUNT; n++) {
+			long i;
 			
 			if(FULL_TEST) {
-				io = entities[handle];
+				i = nearEntities[n];
+				io = entities[nearEntities[n]];
 			} else {
+				i = nearTreatZone[n];
 				io = treatio[i].io;
 			}
 
@@ -841,10 +861,21 @@ bool CheckEverythingInSphere(const Sphere & sphere, long source, EntityHandle ta
 	float sr30 = sphere.radius + 20.f;
 	float sr40 = sphere.radius + 30.f;
 	float sr180 = sphere.radius + 500.f;
-
-	for(long i = 0; i < TREATZONE_CUR; i++) {
+	
+	NearbyList<size_t> nearBuffer;
+	std::vector<size_t> & nearTreatZone = nearBuffer.get();
+	if(ValidIONum(targ)) {
+		if(TREATZONE_CUR > 0) {
+			nearTreatZone.push_back(0);
+		}
+	} else {
+		TREATZONE_GetNear(sphere.origin, sr180, nearTreatZone);
+	}
+	
+	for(size_t n = 0; n < nearTreatZone.size(); n++) {
+		size_t i = nearTreatZone[n];
+		
 		if(ValidIONum(targ)) {
-			i = TREATZONE_CUR;
 			io = entities[targ];
 
 			if(!io
@@ -1046,8 +1077,13 @@ bool CheckAnythingInSphere(const Sphere & sphere, EntityHandle source, CASFlags
 	float sr30 = sphere.radius + 20.f;
 	float sr40 = sphere.radius + 30.f;
 	float sr180 = sphere.radius + 500.f;
-
-	for(long i = 0; i < TREATZONE_CUR; i++) {
+	
+	NearbyList<size_t> nearBuffer;
+	std::vector<size_t> & nearTreatZone = nearBuffer.get();
+	TREATZONE_GetNear(sphere.origin, sr180, nearTreatZone);
+	
+	for(size_t n = 0; n < nearTreatZone.size(); n++) {
+		size_t i = nearTreatZone[n];
 		
 		if(treatio[i].show != 1 || !treatio[i].io || treatio[i].num == source)
 			continue;
@@ -1690,11 +1726,15 @@ void ANCHOR_BLOCK_Clear() {
 		ANCHOR_DATA * ad = &eb->anchors[k];
 		ad->flags &= ~ANCHOR_FLAG_BLOCKED;
 	}
+	
+	EERIE_PATHFINDER_Invalidate_Cache();
 }
 
 void ANCHOR_BLOCK_By_IO(Entity * io, long status) {
 
 	EERIE_BACKGROUND * eb = ACTIVEBKG;
+	
+	bool changed = false;
 
 	for(long k = 0; k < eb->nbanchors; k++) {
 		ANCHOR_DATA * ad = &eb->anchors[k];
@@ -1727,12 +1767,18 @@ void ANCHOR_BLOCK_By_IO(Entity * io, long status) {
 				}
 
 				if(PointIn2DPolyXZ(&ep, ad->pos.x, ad->pos.z)) {
+					AnchorFlags flags = ad->flags;
 					if(status)
 						ad->flags |= ANCHOR_FLAG_BLOCKED;
 					else
 						ad->flags &= ~ANCHOR_FLAG_BLOCKED;
+					changed = changed || ad->flags != flags;
 				}
 			}
 		}
-	}					
+	}
+	
+	if(changed) {
+		EERIE_PATHFINDER_Invalidate_Cache();
+	}
 }
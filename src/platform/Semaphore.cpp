@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform/Semaphore.h"
+
+#include <climits>
+
+#if ARX_HAVE_PTHREADS
+
+Semaphore::Semaphore(unsigned _count) : count(_count) {
+	const pthread_mutex_t mutex_init = PTHREAD_MUTEX_INITIALIZER;
+	mutex = mutex_init;
+	const pthread_cond_t cond_init = PTHREAD_COND_INITIALIZER;
+	cond = cond_init;
+}
+
+Semaphore::~Semaphore() {
+	pthread_cond_destroy(&cond);
+	pthread_mutex_destroy(&mutex);
+}
+
+void Semaphore::wait() {
+	
+	pthread_mutex_lock(&mutex);
+	
+	while(!count) {
+		int rc = pthread_cond_wait(&cond, &mutex);
+		arx_assert(rc == 0);
+		ARX_UNUSED(rc);
+	}
+	
+	count--;
+	pthread_mutex_unlock(&mutex);
+}
+
+void Semaphore::post() {
+	pthread_mutex_lock(&mutex);
+	count++;
+	pthread_cond_signal(&cond);
+	pthread_mutex_unlock(&mutex);
+}
+
+#elif ARX_PLATFORM == ARX_PLATFORM_WIN32
+
+Semaphore::Semaphore(unsigned count) {
+	semaphore = CreateSemaphore(NULL, count, LONG_MAX, NULL);
+}
+
+Semaphore::~Semaphore() {
+	CloseHandle(semaphore);
+}
+
+void Semaphore::wait() {
+	DWORD rc = WaitForSingleObject(semaphore, INFINITE);
+	arx_assert(rc == WAIT_OBJECT_0);
+	ARX_UNUSED(rc);
+}
+
+void Semaphore::post() {
+	ReleaseSemaphore(semaphore, 1, NULL);
+}
+
+#endif
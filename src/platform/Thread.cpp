@@ -263,3 +263,25 @@ void Thread::sleep(unsigned milliseconds) {
 #else
 #error "Sleep not supported: need ARX_HAVE_NANOSLEEP in non-Windows systems"
 #endif
+
+#if ARX_HAVE_SYSCONF
+#include <unistd.h>
+#endif
+
+unsigned Thread::getProcessorCount() {
+	
+#if ARX_HAVE_SYSCONF && defined(_SC_NPROCESSORS_ONLN)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if(count > 0) {
+		return unsigned(count);
+	}
+#elif ARX_PLATFORM == ARX_PLATFORM_WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	if(info.dwNumberOfProcessors > 0) {
+		return unsigned(info.dwNumberOfProcessors);
+	}
+#endif
+	
+	return 1;
+}
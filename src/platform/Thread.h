@@ -107,6 +107,13 @@ public:
 	
 	static thread_id_type getCurrentThreadId();
 	
+	/*!
+	 * \brief Get the number of processors available to this process
+	 *
+	 * \return the number of online processors, or 1 if it could not be determined.
+	 */
+	static unsigned getProcessorCount();
+	
 protected:
 	
 	/*!
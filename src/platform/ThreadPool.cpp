@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform/ThreadPool.h"
+
+#include <algorithm>
+
+#include "platform/Thread.h"
+
+class ThreadPool::Worker : public Thread {
+	
+	ThreadPool & m_pool;
+	
+public:
+	
+	explicit Worker(ThreadPool & pool) : m_pool(pool) { }
+	
+	void run() {
+		for(;;) {
+			m_pool.m_start.wait();
+			if(m_pool.m_stop) {
+				break;
+			}
+			m_pool.process();
+			m_pool.m_done.post();
+		}
+	}
+	
+};
+
+ThreadPool::ThreadPool(size_t threads, const std::string & name)
+	: m_task(NULL)
+	, m_count(0)
+	, m_next(0)
+	, m_stop(false)
+{
+	
+	m_workers.reserve(threads);
+	
+	for(size_t i = 0; i < threads; i++) {
+		Worker * worker = new Worker(*this);
+		worker->setThreadName(name);
+		worker->start();
+		m_workers.push_back(worker);
+	}
+	
+}
+
+ThreadPool::~ThreadPool() {
+	
+	m_stop = true;
+	
+	for(size_t i = 0; i < m_workers.size(); i++) {
+		m_start.post();
+	}
+	
+	for(size_t i = 0; i < m_workers.size(); i++) {
+		m_workers[i]->waitForCompletion();
+		delete m_workers[i];
+	}
+	
+}
+
+void ThreadPool::process() {
+	
+	for(;;) {
+		
+		size_t index;
+		{
+			Autolock lock(m_lock);
+			if(m_next == m_count) {
+				return;
+			}
+			index = m_next++;
+		}
+		
+		m_task->run(index);
+	}
+	
+}
+
+void ThreadPool::run(Task & task, size_t count) {
+	
+	// Not worth waking up other threads for a single item
+	if(m_workers.empty() || count <= 1) {
+		for(size_t i = 0; i < count; i++) {
+			task.run(i);
+		}
+		return;
+	}
+	
+	m_task = &task;
+	m_count = count;
+	m_next = 0;
+	
+	size_t helpers = std::min(m_workers.size(), count - 1);
+	for(size_t i = 0; i < helpers; i++) {
+		m_start.post();
+	}
+	
+	process();
+	
+	for(size_t i = 0; i < helpers; i++) {
+		m_done.wait();
+	}
+	
+	m_task = NULL;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_PLATFORM_THREADPOOL_H
+#define ARX_PLATFORM_THREADPOOL_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "platform/Lock.h"
+#include "platform/Semaphore.h"
+
+/*!
+ * Fixed set of worker threads to spread independent work items over.
+ */
+class ThreadPool : private boost::noncopyable {
+	
+public:
+	
+	//! A batch of independent work items
+	class Task {
+		
+	public:
+		
+		virtual ~Task() { }
+		
+		/*!
+		 * Process one work item.
+		 * Called concurrently from multiple threads, but only once for each index.
+		 */
+		virtual void run(size_t index) = 0;
+		
+	};
+	
+	/*!
+	 * \param threads Number of worker threads to start. The thread calling run() also
+	 *                processes work items, so this should be one less than the number
+	 *                of processors to use.
+	 * \param name    Name for the worker threads.
+	 */
+	ThreadPool(size_t threads, const std::string & name);
+	
+	//! Stop and join all worker threads
+	~ThreadPool();
+	
+	/*!
+	 * Call task.run(i) for every i in [0, count) and wait until all calls have returned.
+	 * Work items are processed by the worker threads and the calling thread.
+	 */
+	void run(Task & task, size_t count);
+	
+	size_t getWorkerCount() const { return m_workers.size(); }
+	
+private:
+	
+	class Worker;
+	
+	//! Process work items of the current task until there are none left
+	void process();
+	
+	std::vector<Worker *> m_workers;
+	
+	Semaphore m_start; // Posted once for each worker that should help with the current task
+	Semaphore m_done; // Posted by each helping worker once it runs out of work items
+	
+	Lock m_lock; // Protects m_next
+	Task * m_task;
+	size_t m_count;
+	size_t m_next;
+	
+	bool m_stop;
+	
+};
+
+#endif // ARX_PLATFORM_THREADPOOL_H
@@ -32,11 +32,13 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/container/flat_map.hpp>
 #include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "io/fs/FilePath.h"
 #include "io/fs/FileStream.h"
 #include "io/log/Logger.h"
 
+#include "platform/Lock.h"
 #include "platform/Thread.h"
 #include "platform/Time.h"
 #include "platform/profiler/ProfilerDataFormat.h"
@@ -56,6 +58,8 @@ public:
 	
 	void addProfilePoint(const char* tag, thread_id_type threadId, u64 startTime, u64 endTime);
 	
+	profiler::Totals * getTotals(const std::string & tag);
+	
 private:
 	static const u32 NB_SAMPLES = 100 * 1000;
 	
@@ -77,6 +81,12 @@ private:
 	
 	ThreadInfos        m_threads;
 	
+	// Totals are never freed so that they stay valid for callers to keep
+	typedef boost::unordered_map<std::string, profiler::Totals *> TotalsMap;
+	
+	TotalsMap          m_totals;
+	Lock               m_totalsLock;
+	
 	boost::array<ProfilerSample, NB_SAMPLES> m_samples;
 	std::atomic<int> m_writeIndex;
 	bool               m_canWrite;
@@ -94,6 +104,12 @@ Profiler::Profiler() {
 void Profiler::reset() {
 	m_writeIndex = 0;
 	m_samples.fill(ProfilerSample());
+	
+	Autolock lock(&m_totalsLock);
+	for(TotalsMap::const_iterator it = m_totals.begin(); it != m_totals.end(); ++it) {
+		it->second->count = 0;
+		it->second->time = 0;
+	}
 }
 
 void Profiler::registerThread(const std::string& threadName) {
@@ -124,6 +140,18 @@ void Profiler::addProfilePoint(const char* tag, thread_id_type threadId, u64 sta
 	sample.endTime = endTime;
 }
 
+profiler::Totals * Profiler::getTotals(const std::string & tag) {
+	
+	Autolock lock(&m_totalsLock);
+	
+	profiler::Totals * & totals = m_totals[tag];
+	if(!totals) {
+		totals = new profiler::Totals(tag);
+	}
+	
+	return totals;
+}
+
 void Profiler::flush() {
 	
 	m_canWrite = false;
@@ -202,6 +230,7 @@ void Profiler::writeProfileLog() {
 	ProfilerStringTable stringTable;
 	std::vector<SavedProfilerThread> threadsData;
 	std::vector<SavedProfilerSample> samplesData;
+	std::vector<SavedProfilerTotals> totalsData;
 	
 	for(ThreadInfos::const_iterator it = m_threads.begin(); it != m_threads.end(); ++it) {
 		const ProfilerThread & thread = it->second;
@@ -238,10 +267,26 @@ void Profiler::writeProfileLog() {
 		samplesData.push_back(saved);
 	}
 	
+	{
+		Autolock lock(&m_totalsLock);
+		for(TotalsMap::const_iterator it = m_totals.begin(); it != m_totals.end(); ++it) {
+			const profiler::Totals & totals = *it->second;
+			if(totals.count == 0) {
+				continue;
+			}
+			SavedProfilerTotals saved;
+			saved.stringIndex = stringTable.add(totals.tag);
+			saved.count = totals.count;
+			saved.time = totals.time;
+			totalsData.push_back(saved);
+		}
+	}
+	
 	LogInfo << "Writing data: "
 	" Strings " << stringTable.entries() <<
 	", Threads " << threadsData.size() <<
-	", Points "  << samplesData.size();
+	", Points "  << samplesData.size() <<
+	", Totals "  << totalsData.size();
 	
 	{
 		std::string stringsData = stringTable.data();
@@ -268,6 +313,14 @@ void Profiler::writeProfileLog() {
 		pos += dataSize;
 	}
 	
+	{
+		int dataSize = totalsData.size() * sizeof(SavedProfilerTotals);
+		writeChunk(out, ArxProfilerChunkType_Totals, dataSize, pos);
+		
+		out.write((const char*) totalsData.data(), dataSize);
+		pos += dataSize;
+	}
+	
 	out.close();
 }
 
@@ -292,16 +345,34 @@ void profiler::unregisterThread() {
 	g_profiler.unregisterThread();
 }
 
+profiler::Totals * profiler::getTotals(const std::string & tag) {
+	return g_profiler.getTotals(tag);
+}
+
 
 ProfileScope::ProfileScope(const char * tag)
 	: m_tag(tag)
+	, m_totals(NULL)
 	, m_startTime(platform::getTimeUs())
 {
 	arx_assert(tag != 0 && tag[0] != '\0');
 }
 
+ProfileScope::ProfileScope(profiler::Totals * totals)
+	: m_tag(totals->tag.c_str())
+	, m_totals(totals)
+	, m_startTime(platform::getTimeUs())
+{
+	arx_assert(!totals->tag.empty());
+}
+
 ProfileScope::~ProfileScope() {
-	g_profiler.addProfilePoint(m_tag, Thread::getCurrentThreadId(), m_startTime, platform::getTimeUs());
+	u64 endTime = platform::getTimeUs();
+	g_profiler.addProfilePoint(m_tag, Thread::getCurrentThreadId(), m_startTime, endTime);
+	if(m_totals) {
+		m_totals->count.fetch_add(1, std::memory_order_relaxed);
+		m_totals->time.fetch_add(endTime - m_startTime, std::memory_order_relaxed);
+	}
 }
 
 #else
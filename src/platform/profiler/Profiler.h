@@ -38,23 +38,56 @@ namespace profiler {
 
 #if BUILD_PROFILER_INSTRUMENT
 
+#include <atomic>
+
+namespace profiler {
+	
+	//! Number of runs and total time of all profile points with the same tag
+	struct Totals {
+		
+		explicit Totals(const std::string & tag_) : tag(tag_), count(0), time(0) { }
+		
+		const std::string tag;
+		std::atomic<u64> count;
+		std::atomic<u64> time;
+		
+	};
+	
+	/*!
+	 * Get the totals for a tag built at runtime, creating them on first use.
+	 * The totals are written to the profile log together with the profile points and
+	 * stay valid until the program exits.
+	 * This takes a lock: look up the totals once and then keep the pointer.
+	 */
+	Totals * getTotals(const std::string & tag);
+	
+}
+
 class ProfileScope {
 public:
 	explicit ProfileScope(const char* tag);
+	explicit ProfileScope(profiler::Totals * totals);
 	~ProfileScope();
 	
 private:
 	const char* m_tag;
+	profiler::Totals * m_totals;
 	u64         m_startTime;
 };
 
-#define ARX_PROFILE(tag)           ProfileScope profileScope##__LINE__(#tag)
-#define ARX_PROFILE_FUNC()         ProfileScope profileScope##__LINE__(__FUNCTION__)
+// Expand __LINE__ before pasting so that multiple scopes can be used in one block
+#define ARX_PROFILE_PASTE(a, b)    a##b
+#define ARX_PROFILE_NAME(line)     ARX_PROFILE_PASTE(profileScope, line)
+
+#define ARX_PROFILE(tag)           ProfileScope ARX_PROFILE_NAME(__LINE__)(#tag)
+#define ARX_PROFILE_FUNC()         ProfileScope ARX_PROFILE_NAME(__LINE__)(__FUNCTION__)
+#define ARX_PROFILE_TOTALS(totals) ProfileScope ARX_PROFILE_NAME(__LINE__)(totals)
 
 #else
 
 #define ARX_PROFILE(tag)           ARX_DISCARD(tag)
 #define ARX_PROFILE_FUNC()         ARX_DISCARD()
+#define ARX_PROFILE_TOTALS(totals) ARX_DISCARD(totals)
 
 #endif // BUILD_PROFILER_INSTRUMENT
 
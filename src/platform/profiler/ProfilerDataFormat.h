@@ -37,7 +37,8 @@ enum ArxProfilerChunkType {
 	ArxProfilerChunkType_None = 0,
 	ArxProfilerChunkType_Strings = 1,
 	ArxProfilerChunkType_Threads = 2,
-	ArxProfilerChunkType_Samples = 3
+	ArxProfilerChunkType_Samples = 3,
+	ArxProfilerChunkType_Totals = 4
 };
 
 struct SavedProfilerChunkHeader {
@@ -62,6 +63,12 @@ struct SavedProfilerSample {
 	u64 endTime;
 };
 
+struct SavedProfilerTotals {
+	u32 stringIndex;
+	u64 count;
+	u64 time;
+};
+
 #pragma pack(pop)
 
 #endif // ARX_PLATFORM_PROFILER_PROFILERDATAFORMAT_H
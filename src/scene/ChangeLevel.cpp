@@ -1854,18 +1854,19 @@ static long ARX_CHANGELEVEL_Pop_Player() {
 	return 1;
 }
 
-static bool loadScriptVariables(SCRIPT_VARIABLES& var, const char * dat, size_t & pos, VariableType ttext, VariableType tlong, VariableType tfloat) {
+static bool loadScriptVariables(SCRIPT_VARIABLES & var, size_t count, const char * dat, size_t & pos,
+                                VariableType ttext, VariableType tlong, VariableType tfloat) {
 	
-	for(size_t i = 0; i < var.size(); i++) {
+	for(size_t i = 0; i < count; i++) {
 		
 		const ARX_CHANGELEVEL_VARIABLE_SAVE * avs;
 		avs = reinterpret_cast<const ARX_CHANGELEVEL_VARIABLE_SAVE *>(dat + pos);
 		pos += sizeof(ARX_CHANGELEVEL_VARIABLE_SAVE);
 		
-		var[i].name = boost::to_lower_copy(util::loadString(avs->name));
+		std::string name = boost::to_lower_copy(util::loadString(avs->name));
 			
-		if(var[i].name.find_first_not_of("abcdefghijklmnopqrstuvwxyz_0123456789", 1) != std::string::npos) {
-			LogWarning << "Unexpected variable name \"" << var[i].name.substr(1) << '"';
+		if(name.find_first_not_of("abcdefghijklmnopqrstuvwxyz_0123456789", 1) != std::string::npos) {
+			LogWarning << "Unexpected variable name \"" << name.substr(1) << '"';
 		}
 		
 		VariableType type;
@@ -1879,27 +1880,28 @@ static bool loadScriptVariables(SCRIPT_VARIABLES& var, const char * dat, size_t
 			type = tlong;
 		} else {
 			LogError << "Unknown script variable type: " << avs->type;
-			var.resize(i);
 			return false;
 		}
 		
-		var[i].fval = avs->fval;
-		var[i].ival = (long)avs->fval;
-		var[i].type = type;
+		SCRIPT_VAR & v = var.add(name);
+		
+		v.fval = avs->fval;
+		v.ival = (long)avs->fval;
+		v.type = type;
 		
 		if(type == ttext) {
-			if(var[i].ival) {
-				var[i].text = boost::to_lower_copy(util::loadString(dat + pos, (long)avs->fval));
+			if(v.ival) {
+				v.text = boost::to_lower_copy(util::loadString(dat + pos, (long)avs->fval));
 				pos += (long)avs->fval;
-				if(var[i].text[0] == '\xCC') {
-					var[i].text[0] = 0;
+				if(v.text[0] == '\xCC') {
+					v.text[0] = 0;
 				}
 			}
 		}
 		
 		LogDebug(((type & (TYPE_G_TEXT|TYPE_G_LONG|TYPE_G_FLOAT)) ? "global " : "local ") \
 		<< ((type & (TYPE_L_TEXT|TYPE_G_TEXT)) ? "text" : (type & (TYPE_L_LONG|TYPE_G_LONG)) ? "long" : (type & (TYPE_L_FLOAT|TYPE_G_FLOAT)) ? "float" : "unknown") \
-		<< " \"" << var[i].name.substr(1) << "\" = " << var[i].fval << ' ' << var[i].text \
+		<< " \"" << v.name.substr(1) << "\" = " << v.fval << ' ' << v.text \
 		);
 		
 	}
@@ -1916,9 +1918,8 @@ static bool loadScriptData(EERIE_SCRIPT & script, const char * dat, size_t & pos
 	script.allowevents = DisabledEvents::load(ass->allowevents); // TODO save/load flags
 
 	script.lvar.clear();
-	script.lvar.resize(ass->nblvar);
 
-	return loadScriptVariables(script.lvar, dat, pos,
+	return loadScriptVariables(script.lvar, ass->nblvar, dat, pos,
 	                           TYPE_L_TEXT, TYPE_L_LONG, TYPE_L_FLOAT);
 }
 
@@ -2156,6 +2157,8 @@ static Entity * ARX_CHANGELEVEL_Pop_IO(const std::string & idString, EntityInsta
 			}
 			
 			scr_timer[num].times = ats->times;
+			
+			ARX_SCRIPT_Timer_Register(num);
 		}
 		
 		if(!loadScriptData(io->script, dat, pos) || !loadScriptData(io->over_script, dat, pos)) {
@@ -2577,9 +2580,9 @@ static void ARX_CHANGELEVEL_Pop_Globals() {
 	}
 	
 	svar.clear();
-	svar.resize(acsg->nb_globals);
 		
-	bool ret = loadScriptVariables(svar, dat, pos, TYPE_G_TEXT, TYPE_G_LONG, TYPE_G_FLOAT);
+	bool ret = loadScriptVariables(svar, acsg->nb_globals, dat, pos,
+	                               TYPE_G_TEXT, TYPE_G_LONG, TYPE_G_FLOAT);
 	if(!ret) {
 		LogError << "Error loading globals";
 	}
@@ -2699,6 +2702,7 @@ static bool ARX_CHANGELEVEL_PopLevel(long instance, bool reloadflag) {
 				scr_timer[i].tim = ulDTime;
 			}
 		}
+		ARX_SCRIPT_Timer_Reschedule();
 	} else {
 		LogDebug("Before ARX_CHANGELEVEL_PopAllIO");
 		ARX_CHANGELEVEL_PopAllIO(&asi);
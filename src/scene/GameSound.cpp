@@ -109,6 +109,7 @@ struct PlayingAmbiance {
 
 static const unsigned long ARX_SOUND_UPDATE_INTERVAL(100);  
 static const unsigned long ARX_SOUND_STREAMING_LIMIT(176400); 
+static const unsigned long ARX_SOUND_CACHE_LIMIT(32 * 1024 * 1024);
 static const unsigned long MAX_MATERIALS(17);
 static const unsigned long MAX_VARIANTS(5);
 static const unsigned long AMBIANCE_FADE_TIME(2000);
@@ -382,6 +383,7 @@ bool ARX_SOUND_Init() {
 	}
 	
 	audio::setStreamLimit(ARX_SOUND_STREAMING_LIMIT);
+	audio::setCacheLimit(ARX_SOUND_CACHE_LIMIT);
 	
 	audio::setUnitFactor(ARX_SOUND_UNIT_FACTOR);
 	audio::setRolloffFactor(ARX_SOUND_ROLLOFF_FACTOR);
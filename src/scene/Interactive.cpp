@@ -47,8 +47,10 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "scene/Interactive.h"
 
 #include <cstdlib>
+#include <cmath>
 #include <iomanip>
 #include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -106,7 +108,6 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "physics/Box.h"
 #include "physics/Clothes.h"
 
-#include "platform/Thread.h"
 #include "platform/profiler/Profiler.h"
 
 #include "scene/ChangeLevel.h"
@@ -227,11 +228,8 @@ void ARX_INTERACTIVE_DestroyDynamicInfo(Entity * io)
 	}
 	
 	if(io->ioflags & IO_NPC) {
-		// to check again later...
-		long count = 50;
-		while((io->_npcdata->pathfind.pathwait == 1) && count--) {
-			Thread::sleep(1);
-		}
+		// Pathfinder workers never write to the entity, and results for released
+		// entities are dropped, so there is no need to wait for pending requests.
 		free(io->_npcdata->pathfind.list);
 		io->_npcdata->pathfind = IO_PATHFIND();
 	}
@@ -409,6 +407,7 @@ static long TREATZONE_MAX = 0;
 
 void TREATZONE_Clear() {
 	TREATZONE_CUR = 0;
+	ARX_INTERACTIVE_InvalidateGrid();
 }
 
 void TREATZONE_Release() {
@@ -452,6 +451,178 @@ void TREATZONE_AddIO(Entity * io, bool justCollide)
 	treatio[TREATZONE_CUR].show = io->show;
 	treatio[TREATZONE_CUR].num = io->index();
 	TREATZONE_CUR++;
+	
+	ARX_INTERACTIVE_InvalidateGrid();
+}
+
+const float EntityGrid::CELL_SIZE = 500.f;
+
+EntityGrid::EntityGrid() : m_buckets(BUCKETS) { }
+
+size_t EntityGrid::getBucket(long x, long z) {
+	return (size_t(x) * 73856093u ^ size_t(z) * 19349663u) % BUCKETS;
+}
+
+void EntityGrid::update(size_t index, const Vec3f & pos) {
+	
+	long x = long(std::floor(pos.x / CELL_SIZE));
+	long z = long(std::floor(pos.z / CELL_SIZE));
+	size_t bucket = getBucket(x, z);
+	
+	if(index >= m_entries.size()) {
+		Entry entry = { NONE, 0 };
+		m_entries.resize(index + 1, entry);
+	}
+	
+	if(m_entries[index].bucket == bucket) {
+		return;
+	}
+	
+	remove(index);
+	
+	m_entries[index].bucket = bucket;
+	m_entries[index].slot = m_buckets[bucket].size();
+	m_buckets[bucket].push_back(index);
+}
+
+void EntityGrid::remove(size_t index) {
+	
+	if(index >= m_entries.size() || m_entries[index].bucket == NONE) {
+		return;
+	}
+	
+	// Move the last entry of the bucket into the freed slot
+	Entry & entry = m_entries[index];
+	std::vector<size_t> & bucket = m_buckets[entry.bucket];
+	size_t last = bucket.back();
+	bucket[entry.slot] = last;
+	m_entries[last].slot = entry.slot;
+	bucket.pop_back();
+	
+	entry.bucket = NONE;
+}
+
+void EntityGrid::truncate(size_t count) {
+	
+	for(size_t i = count; i < m_entries.size(); i++) {
+		remove(i);
+	}
+	
+	if(count < m_entries.size()) {
+		m_entries.resize(count);
+	}
+}
+
+void EntityGrid::query(const Vec2f & min, const Vec2f & max, std::vector<size_t> & result) const {
+	
+	long x0 = long(std::floor(min.x / CELL_SIZE));
+	long z0 = long(std::floor(min.y / CELL_SIZE));
+	long x1 = long(std::floor(max.x / CELL_SIZE));
+	long z1 = long(std::floor(max.y / CELL_SIZE));
+	
+	if(size_t(x1 - x0 + 1) * size_t(z1 - z0 + 1) >= BUCKETS) {
+		// Large query - every bucket would be visited anyway
+		for(size_t i = 0; i < BUCKETS; i++) {
+			result.insert(result.end(), m_buckets[i].begin(), m_buckets[i].end());
+		}
+		return;
+	}
+	
+	for(long z = z0; z <= z1; z++) {
+		for(long x = x0; x <= x1; x++) {
+			const std::vector<size_t> & bucket = m_buckets[getBucket(x, z)];
+			result.insert(result.end(), bucket.begin(), bucket.end());
+		}
+	}
+}
+
+// Index of all entities and of the treat zone, updated lazily once per frame
+static EntityGrid g_entityGrid;
+static EntityGrid g_treatZoneGrid;
+static size_t g_entityGridCount = 0;
+static bool g_entityGridDirty = true;
+
+// Entities may still move after the grids have been updated - extend queries by this distance
+static const float ENTITY_GRID_MARGIN = 200.f;
+
+void ARX_INTERACTIVE_InvalidateGrid() {
+	g_entityGridDirty = true;
+}
+
+static void updateEntityGrid() {
+	
+	if(!g_entityGridDirty) {
+		return;
+	}
+	
+	ARX_PROFILE_FUNC();
+	
+	// Only entries that have changed cells are moved
+	for(size_t i = 0; i < entities.size(); i++) {
+		const Entity * io = entities[EntityHandle(i)];
+		if(io) {
+			g_entityGrid.update(i, io->pos);
+		} else {
+			g_entityGrid.remove(i);
+		}
+	}
+	g_entityGrid.truncate(entities.size());
+	g_entityGridCount = entities.size();
+	
+	for(long i = 0; i < TREATZONE_CUR; i++) {
+		if(treatio[i].io) {
+			g_treatZoneGrid.update(i, treatio[i].io->pos);
+		} else {
+			g_treatZoneGrid.remove(i);
+		}
+	}
+	g_treatZoneGrid.truncate(TREATZONE_CUR);
+	
+	g_entityGridDirty = false;
+}
+
+/*!
+ * Sort the indices appended to a list since begin and remove duplicates.
+ * Callers expect the order of a linear search.
+ */
+template <typename T>
+static void sortNearby(std::vector<T> & list, size_t begin) {
+	std::sort(list.begin() + begin, list.end());
+	list.erase(std::unique(list.begin() + begin, list.end()), list.end());
+}
+
+void ARX_INTERACTIVE_GetNear(const Vec3f & pos, float radius, std::vector<EntityHandle> & result) {
+	
+	updateEntityGrid();
+	
+	NearbyList<size_t> buffer;
+	std::vector<size_t> & found = buffer.get();
+	
+	float r = radius + ENTITY_GRID_MARGIN;
+	g_entityGrid.query(Vec2f(pos.x - r, pos.z - r), Vec2f(pos.x + r, pos.z + r), found);
+	
+	// Entities added since the grid was updated
+	for(size_t i = g_entityGridCount; i < entities.size(); i++) {
+		found.push_back(i);
+	}
+	
+	sortNearby(found, 0);
+	
+	for(size_t i = 0; i < found.size(); i++) {
+		result.push_back(EntityHandle(found[i]));
+	}
+}
+
+void TREATZONE_GetNear(const Vec3f & pos, float radius, std::vector<size_t> & result) {
+	
+	updateEntityGrid();
+	
+	size_t begin = result.size();
+	
+	float r = radius + ENTITY_GRID_MARGIN;
+	g_treatZoneGrid.query(Vec2f(pos.x - r, pos.z - r), Vec2f(pos.x + r, pos.z + r), result);
+	
+	sortNearby(result, begin);
 }
 
 void CheckSetAnimOutOfTreatZone(Entity * io, AnimLayer & layer) {
@@ -1151,6 +1322,7 @@ void ARX_INTERACTIVE_TeleportBehindTarget(Entity * io)
 			scr_timer[num].pos = -1; 
 			scr_timer[num].tim = (unsigned long)(arxtime);
 			scr_timer[num].times = 1;
+			ARX_SCRIPT_Timer_Register(num);
 			entities[t]->show = SHOW_FLAG_TELEPORTING;
 			AddRandomSmoke(io, 10);
 			ARX_PARTICLES_Add_Smoke(io->pos, 3, 20);
@@ -1246,6 +1418,8 @@ void ARX_INTERACTIVE_Teleport(Entity * io, const Vec3f & target, bool flag) {
 	Vec3f translate = target - io->pos;
 	io->lastpos = io->physics.cyl.origin = io->pos = target;
 	
+	ARX_INTERACTIVE_InvalidateGrid();
+	
 	if(io->obj) {
 		if(io->obj->pbox) {
 			if(io->obj->pbox->active) {
@@ -2016,8 +2190,12 @@ Entity * InterClick(const Vec2s & pos) {
 // Need To upgrade to a more precise collision.
 long IsCollidingAnyInter(const Vec3f & pos, const Vec3f & size) {
 	
-	for(size_t i = 0; i < entities.size(); i++) {
-		const EntityHandle handle = EntityHandle(i);
+	NearbyList<EntityHandle> nearBuffer;
+	std::vector<EntityHandle> & nearEntities = nearBuffer.get();
+	ARX_INTERACTIVE_GetNear(pos, 190.f, nearEntities);
+	
+	for(size_t i = 0; i < nearEntities.size(); i++) {
+		const EntityHandle handle = nearEntities[i];
 		Entity * io = entities[handle];
 
 		if(   io
@@ -2031,12 +2209,12 @@ long IsCollidingAnyInter(const Vec3f & pos, const Vec3f & size) {
 			Vec3f tempPos = pos;
 			
 			if(IsCollidingInter(io, tempPos))
-				return i;
+				return handle;
 
 			tempPos.y += size.y;
 
 			if(IsCollidingInter(io, tempPos))
-				return i;
+				return handle;
 		}
 	}
 
@@ -2445,9 +2623,11 @@ void UpdateInter() {
 				pos.y = io->_npcdata->vvpos;
 			}
 
-			EERIEDrawAnimQuatUpdate(io->obj, io->animlayer, temp, pos, diff, io, true);
+			EERIEDrawAnimQuatUpdateDeferred(io->obj, io->animlayer, temp, pos, diff, io, true);
 		}
 	}
+	
+	EERIEDrawAnimQuatFlush();
 }
 
 
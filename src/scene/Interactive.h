@@ -48,7 +48,11 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #define ARX_SCENE_INTERACTIVE_H
 
 #include <stddef.h>
+#include <deque>
 #include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
 
 #include "game/Entity.h"
 #include "game/EntityId.h"
@@ -171,6 +175,114 @@ void TREATZONE_Clear();
 void TREATZONE_Release();
 void TREATZONE_AddIO(Entity * io, bool justCollide = false);
 void TREATZONE_RemoveIO(Entity * io);
+
+/*!
+ * Uniform grid over entity positions in the XZ plane.
+ * Used to find the entities near a position without walking all entities.
+ * Cells are hashed into a fixed number of buckets so that the grid does not need bounds.
+ * Moving an entry only touches the grid if it changes cells.
+ */
+class EntityGrid {
+	
+public:
+	
+	static const float CELL_SIZE;
+	
+	EntityGrid();
+	
+	//! Add an entry or update its position
+	void update(size_t index, const Vec3f & pos);
+	
+	//! Remove an entry if it is in the grid
+	void remove(size_t index);
+	
+	//! Remove all entries with an index that is greater or equal to count
+	void truncate(size_t count);
+	
+	/*!
+	 * Get the entries with a position inside the given XZ rectangle.
+	 * The result may also contain entries outside the rectangle and may contain duplicates.
+	 * \param result Indices of the entries are appended to this list.
+	 */
+	void query(const Vec2f & min, const Vec2f & max, std::vector<size_t> & result) const;
+	
+private:
+	
+	static const size_t BUCKETS = 1024;
+	static const size_t NONE = size_t(-1);
+	
+	struct Entry {
+		size_t bucket; // NONE if the entry is not in the grid
+		size_t slot; // Position in the bucket
+	};
+	
+	static size_t getBucket(long x, long z);
+	
+	std::vector<Entry> m_entries; // Indexed by entry index
+	std::vector< std::vector<size_t> > m_buckets;
+	
+};
+
+/*!
+ * Mark the entity grids as outdated.
+ * Must be called when entities are created, removed or teleported, and once per frame
+ * after entities have moved.
+ */
+void ARX_INTERACTIVE_InvalidateGrid();
+
+/*!
+ * Result list for ARX_INTERACTIVE_GetNear() and TREATZONE_GetNear() that keeps its
+ * memory between queries.
+ * Lists are reused in scope order, so a query made while processing the result of another
+ * query (for example from a script event) gets a different list.
+ */
+template <typename T>
+class NearbyList : private boost::noncopyable {
+	
+	static std::deque< std::vector<T> > s_lists;
+	static size_t s_used;
+	
+	std::vector<T> & m_list;
+	
+	static std::vector<T> & acquire() {
+		if(s_used == s_lists.size()) {
+			s_lists.resize(s_used + 1);
+		}
+		std::vector<T> & list = s_lists[s_used++];
+		list.clear();
+		return list;
+	}
+	
+public:
+	
+	NearbyList() : m_list(acquire()) { }
+	~NearbyList() { s_used--; }
+	
+	std::vector<T> & get() { return m_list; }
+	
+};
+
+template <typename T>
+std::deque< std::vector<T> > NearbyList<T>::s_lists;
+
+template <typename T>
+size_t NearbyList<T>::s_used = 0;
+
+/*!
+ * Find entities near a position.
+ * \param result Handles of all entities that were inside the XZ square of the given radius
+ *               around pos when the grid was last updated are appended to this list in
+ *               increasing order, as well as some entities just outside of that square.
+ */
+void ARX_INTERACTIVE_GetNear(const Vec3f & pos, float radius, std::vector<EntityHandle> & result);
+
+/*!
+ * Find treat zone entries near a position.
+ * \param result Indices into treatio of all entities that were inside the XZ square of the
+ *               given radius around pos when the grid was last updated are appended to
+ *               this list in increasing order, as well as some entities just outside.
+ */
+void TREATZONE_GetNear(const Vec3f & pos, float radius, std::vector<size_t> & result);
 bool IsSameObject(Entity * io, Entity * ioo);
 void ARX_INTERACTIVE_ClearAllDynData();
 bool HaveCommonGroup(Entity * io, Entity * ioo);
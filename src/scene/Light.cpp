@@ -44,6 +44,10 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "scene/Light.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "core/Application.h"
 #include "core/GameTime.h"
 #include "core/Core.h"
@@ -74,6 +78,115 @@ long TOTPDL = 0;
 static EERIE_LIGHT * IO_PDL[MAX_DYNLIGHTS];
 long TOTIOPDL = 0;
 
+const float LightGrid::CELL_SIZE = 500.f;
+
+void LightGrid::build(const EERIE_LIGHT * const * lights, size_t count) {
+	
+	m_cells.clear();
+	m_lights.clear();
+	m_maxFalloff = 0.f;
+	
+	Vec2f min(std::numeric_limits<float>::max());
+	Vec2f max(-std::numeric_limits<float>::max());
+	for(size_t i = 0; i < count; i++) {
+		if(lights[i]) {
+			min = glm::min(min, Vec2f(lights[i]->pos.x, lights[i]->pos.z));
+			max = glm::max(max, Vec2f(lights[i]->pos.x, lights[i]->pos.z));
+			m_maxFalloff = std::max(m_maxFalloff, lights[i]->fallend);
+		}
+	}
+	
+	if(min.x > max.x) {
+		m_size = Vec2i(0);
+		return;
+	}
+	
+	m_origin = min;
+	m_size.x = long((max.x - min.x) / CELL_SIZE) + 1;
+	m_size.y = long((max.y - min.y) / CELL_SIZE) + 1;
+	
+	// Count the lights in each cell, then store them grouped by cell
+	std::vector<size_t> lightCells(count);
+	m_cells.resize(m_size.x * m_size.y + 1, 0);
+	for(size_t i = 0; i < count; i++) {
+		if(lights[i]) {
+			long x = long((lights[i]->pos.x - m_origin.x) / CELL_SIZE);
+			long z = long((lights[i]->pos.z - m_origin.y) / CELL_SIZE);
+			lightCells[i] = z * m_size.x + x;
+			m_cells[lightCells[i] + 1]++;
+		}
+	}
+	
+	for(size_t i = 1; i < m_cells.size(); i++) {
+		m_cells[i] += m_cells[i - 1];
+	}
+	
+	m_lights.resize(m_cells.back());
+	std::vector<size_t> fill(m_cells.begin(), m_cells.end() - 1);
+	for(size_t i = 0; i < count; i++) {
+		if(lights[i]) {
+			m_lights[fill[lightCells[i]]++] = i;
+		}
+	}
+}
+
+void LightGrid::query(const Vec2f & min, const Vec2f & max, std::vector<size_t> & result) const {
+	
+	long x0 = std::max(long(std::floor((min.x - m_origin.x) / CELL_SIZE)), 0l);
+	long z0 = std::max(long(std::floor((min.y - m_origin.y) / CELL_SIZE)), 0l);
+	long x1 = std::min(long(std::floor((max.x - m_origin.x) / CELL_SIZE)), long(m_size.x) - 1);
+	long z1 = std::min(long(std::floor((max.y - m_origin.y) / CELL_SIZE)), long(m_size.y) - 1);
+	
+	for(long z = z0; z <= z1; z++) {
+		for(long x = x0; x <= x1; x++) {
+			size_t cell = z * m_size.x + x;
+			result.insert(result.end(), m_lights.begin() + m_cells[cell],
+			              m_lights.begin() + m_cells[cell + 1]);
+		}
+	}
+}
+
+// Index of the static lights, rebuilt lazily after GLight changes
+static LightGrid g_lightGrid;
+static std::vector<size_t> g_semiDynamicLights;
+static bool g_lightGridDirty = true;
+static unsigned long g_lightVersion = 0;
+
+static void invalidateLightGrid() {
+	g_lightGridDirty = true;
+	g_lightVersion++;
+}
+
+static void updateLightGrid() {
+	
+	if(!g_lightGridDirty) {
+		return;
+	}
+	
+	g_lightGrid.build(GLight, MAX_LIGHTS);
+	
+	g_semiDynamicLights.clear();
+	for(size_t i = 0; i < MAX_LIGHTS; i++) {
+		if(GLight[i] && (GLight[i]->extras & EXTRAS_SEMIDYNAMIC)) {
+			g_semiDynamicLights.push_back(i);
+		}
+	}
+	
+	g_lightGridDirty = false;
+}
+
+void EERIE_LIGHT_GetNear(const Vec3f & pos, float radius, std::vector<size_t> & result) {
+	
+	updateLightGrid();
+	
+	g_lightGrid.query(Vec2f(pos.x - radius, pos.z - radius), Vec2f(pos.x + radius, pos.z + radius),
+	                  result);
+}
+
+unsigned long EERIE_LIGHT_GetVersion() {
+	return g_lightVersion;
+}
+
 void ColorMod::updateFromEntity(Entity *io, bool inBook) {
 	factor = Color3f::white;
 	term = Color3f::black;
@@ -110,6 +223,8 @@ void EERIE_LIGHT_GlobalInit() {
 	
 	static long init = 0;
 	
+	invalidateLightGrid();
+	
 	if(!init) {
 		memset(GLight, 0, sizeof(*GLight) * MAX_LIGHTS);
 		init = 1;
@@ -143,6 +258,8 @@ long EERIE_LIGHT_Create() {
 	for (size_t i = 0; i < MAX_LIGHTS; i++) {
 		if(!GLight[i]) {
 			
+			invalidateLightGrid();
+			
 			GLight[i] = (EERIE_LIGHT *)malloc(sizeof(EERIE_LIGHT));
 			if(!GLight[i]) {
 				return -1;
@@ -177,6 +294,7 @@ void EERIE_LIGHT_GlobalAdd(const EERIE_LIGHT * el)
 
 	if (num > -1)
 	{
+		invalidateLightGrid();
 		GLight[num] = (EERIE_LIGHT *)malloc(sizeof(EERIE_LIGHT));
 		memcpy(GLight[num], el, sizeof(EERIE_LIGHT));
 		GLight[num]->m_ignitionLightHandle = LightHandle::Invalid;
@@ -185,6 +303,9 @@ void EERIE_LIGHT_GlobalAdd(const EERIE_LIGHT * el)
 }
 
 void EERIE_LIGHT_MoveAll(const Vec3f & trans) {
+	
+	invalidateLightGrid();
+	
 	for(size_t i = 0; i < MAX_LIGHTS; i++) {
 		if(GLight[i]) {
 			GLight[i]->pos += trans;
@@ -214,8 +335,10 @@ void TreatBackgroundDynlights() {
 	
 	ARX_PROFILE_FUNC();
 	
-	for(size_t i = 0; i < MAX_LIGHTS; i++) {
-		EERIE_LIGHT *light = GLight[i];
+	updateLightGrid();
+	
+	for(size_t i = 0; i < g_semiDynamicLights.size(); i++) {
+		EERIE_LIGHT *light = GLight[g_semiDynamicLights[i]];
 
 		if(light && (light->extras & EXTRAS_SEMIDYNAMIC)) {
 			
@@ -355,9 +478,13 @@ void PrecalcDynamicLighting(long x0, long z0, long x1, long z1) {
 void PrecalcIOLighting(const Vec3f & pos, float radius) {
 
 	TOTIOPDL = 0;
-
-	for(size_t i = 0; i < MAX_LIGHTS; i++) {
-		EERIE_LIGHT * el = GLight[i];
+	
+	static std::vector<size_t> nearLights;
+	nearLights.clear();
+	EERIE_LIGHT_GetNear(pos, radius, nearLights);
+	
+	for(size_t i = 0; i < nearLights.size(); i++) {
+		EERIE_LIGHT * el = GLight[nearLights[i]];
 
 		if(   el
 		   && el->exist
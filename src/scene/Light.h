@@ -49,6 +49,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #define ARX_SCENE_LIGHT_H
 
 #include <stddef.h>
+#include <vector>
 
 #include "audio/AudioTypes.h"
 #include "graphics/BaseGraphicsTypes.h"
@@ -124,6 +125,45 @@ struct EERIE_LIGHT {
 	math::Quantizer m_storedFlameTime;
 };
 
+/*!
+ * Uniform grid over light positions in the XZ plane.
+ * Used to find the lights near a position without walking the whole light list.
+ * The grid does not track changes to the lights - it must be rebuilt when lights move.
+ */
+class LightGrid {
+	
+public:
+	
+	static const float CELL_SIZE;
+	
+	LightGrid() : m_origin(0.f), m_size(0), m_maxFalloff(0.f) { }
+	
+	/*!
+	 * Index the given lights.
+	 * NULL entries are skipped, the indices returned by query() are indices into this list.
+	 */
+	void build(const EERIE_LIGHT * const * lights, size_t count);
+	
+	/*!
+	 * Get the lights with a position inside the given XZ rectangle.
+	 * The result may also contain lights near but outside the rectangle.
+	 * \param result Indices of the lights are appended to this list.
+	 */
+	void query(const Vec2f & min, const Vec2f & max, std::vector<size_t> & result) const;
+	
+	//! Largest fallend of all indexed lights
+	float getMaxFalloff() const { return m_maxFalloff; }
+	
+private:
+	
+	Vec2f m_origin;
+	Vec2i m_size;
+	float m_maxFalloff;
+	std::vector<size_t> m_cells; // Start of each cell in m_lights, plus one end marker
+	std::vector<size_t> m_lights;
+	
+};
+
 struct ColorMod {
 
 	void updateFromEntity(Entity * io, bool inBook = false);
@@ -143,6 +183,20 @@ void EERIE_LIGHT_MoveAll(const Vec3f & trans);
 long EERIE_LIGHT_Create();
 void PrecalcIOLighting(const Vec3f & pos, float radius);
 
+/*!
+ * Find static lights near a position.
+ * \param result Indices into GLight of all lights inside the XZ square of the given
+ *               radius around pos are appended to this list, as well as some lights
+ *               just outside of that square.
+ */
+void EERIE_LIGHT_GetNear(const Vec3f & pos, float radius, std::vector<size_t> & result);
+
+/*!
+ * Get a counter that changes whenever static lights are created, freed or moved.
+ * Used to find out when other indices of the light positions need to be rebuilt.
+ */
+unsigned long EERIE_LIGHT_GetVersion();
+
 const LightHandle torchLightHandle = (LightHandle)0;
 
 EERIE_LIGHT * lightHandleGet(LightHandle lightHandle);
@@ -475,6 +475,18 @@ Entity * LoadInter_Ex(const res::path & classPath, EntityInstance instance,
 	return io;
 }
 
+static res::path getInterClassPath(const DANAE_LS_INTER * dli) {
+	
+	std::string pathstr = boost::to_lower_copy(util::loadString(dli->name));
+	
+	size_t pos = pathstr.find("graph");
+	if(pos != std::string::npos) {
+		pathstr = pathstr.substr(pos);
+	}
+	
+	return res::path::load(pathstr).remove_ext();
+}
+
 static ColorBGRA savedColorConversion(u32 bgra) {
 	return ColorBGRA(bgra);
 }
@@ -613,6 +625,16 @@ bool DanaeLoadLevel(const res::path & file, bool loadEntities) {
 		LoadLevelScreen();
 	}
 	
+	if(loadEntities && dlh.nb_inter > 0) {
+		// Decompress the entity meshes in parallel before creating the entities one by one
+		std::vector<res::path> meshes;
+		const DANAE_LS_INTER * dli = reinterpret_cast<const DANAE_LS_INTER *>(dat + pos);
+		for(long i = 0; i < dlh.nb_inter; i++) {
+			meshes.push_back(getInterClassPath(&dli[i]) + ".teo");
+		}
+		ARX_FTL_Preload(meshes);
+	}
+	
 	for(long i = 0 ; i < dlh.nb_inter ; i++) {
 		
 		progressBarAdvance(increment);
@@ -622,19 +644,14 @@ bool DanaeLoadLevel(const res::path & file, bool loadEntities) {
 		pos += sizeof(DANAE_LS_INTER);
 		
 		if(loadEntities) {
-			
-			std::string pathstr = boost::to_lower_copy(util::loadString(dli->name));
-			
-			size_t pos = pathstr.find("graph");
-			if(pos != std::string::npos) {
-				pathstr = pathstr.substr(pos);
-			}
-			
-			res::path classPath = res::path::load(pathstr).remove_ext();
+			res::path classPath = getInterClassPath(dli);
 			LoadInter_Ex(classPath, dli->ident, dli->pos.toVec3(), dli->angle, trans);
 		}
 	}
 	
+	// Don't keep a parsed copy of every mesh around after the entities have been created
+	MCache_ClearAll();
+	
 	if(dlh.lighting) {
 		
 		const DANAE_LS_LIGHTINGHEADER * dll = reinterpret_cast<const DANAE_LS_LIGHTINGHEADER *>(dat + pos);
@@ -823,9 +840,15 @@ bool DanaeLoadLevel(const res::path & file, bool loadEntities) {
 		
 		// using compression
 		if(dlh.version >= 1.44f) {
-			char * compressed = lightingFile->readAlloc();
-			dat = (char*)blastMemAlloc(compressed, lightingFile->size(), FileSize);
-			free(compressed);
+			const char * compressed = lightingFile->data();
+			char * compressedCopy = NULL;
+			if(!compressed) {
+				compressed = compressedCopy = lightingFile->readAlloc();
+			}
+			if(compressed) {
+				dat = blastMemAlloc(compressed, lightingFile->size(), FileSize);
+			}
+			free(compressedCopy);
 		} else {
 			dat = lightingFile->readAlloc();
 			FileSize = lightingFile->size();
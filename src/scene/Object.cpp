@@ -46,6 +46,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "scene/Object.h"
 
+#include <algorithm>
 #include <cstdio>
 
 #include <boost/algorithm/string/case_conv.hpp>
@@ -1089,29 +1090,21 @@ void EERIE_CreateCedricData(EERIE_3DOBJ * eobj) {
 			bone.father = GetFather(eobj, group.origin, i - 1);
 		}
 
-		delete[] temp;
-
 		// Try to correct lonely vertex
 		for(size_t i = 0; i < eobj->vertexlist.size(); i++) {
-			long ok = 0;
-
-			for(size_t j = 0; j < eobj->grouplist.size(); j++) {
-				for(size_t k = 0; k < eobj->grouplist[j].indexes.size(); k++) {
-					if((size_t)eobj->grouplist[j].indexes[k] == i) {
-						ok = 1;
-						break;
-					}
-				}
-
-				if(ok)
-					break;
-			}
-
-			if(!ok) {
+			if(!temp[i]) {
 				eobj->m_skeleton->bones[0].idxvertices.push_back(i);
 			}
 		}
 		
+		delete[] temp;
+		
+		// Keep the vertex writes of each bone in memory order when skinning
+		for(size_t i = 0; i < eobj->m_skeleton->bones.size(); i++) {
+			std::vector<long> & indices = eobj->m_skeleton->bones[i].idxvertices;
+			std::sort(indices.begin(), indices.end());
+		}
+		
 		for(long i = eobj->grouplist.size() - 1; i >= 0; i--) {
 			Bone & bone = eobj->m_skeleton->bones[i];
 
@@ -1146,26 +1139,25 @@ void EERIE_CreateCedricData(EERIE_3DOBJ * eobj) {
 			bone.anim.scale = Vec3f_ONE;
 		}
 
+		// Every vertex belongs to exactly one bone: store the local vertices in bone order
+		// so that skinning can read them sequentially.
 		eobj->vertexlocal = new Vec3f[eobj->vertexlist.size()];
-		// TODO constructor is better than memset
-		memset(eobj->vertexlocal, 0, sizeof(Vec3f)*eobj->vertexlist.size());
+		Vec3f * outVert = eobj->vertexlocal;
 
 		for(size_t i = 0; i != obj->bones.size(); i++) {
 			Vec3f vector = obj->bones[i].anim.trans;
+			glm::quat inverse = glm::inverse(obj->bones[i].anim.quat);
 			
 			for(size_t v = 0; v != obj->bones[i].idxvertices.size(); v++) {
 				
 				long idx = obj->bones[i].idxvertices[v];
 				const EERIE_VERTEX & inVert = eobj->vertexlist[idx];
-				Vec3f & outVert = eobj->vertexlocal[idx];
 				
-				Vec3f temp = inVert.v - vector;
-				temp = glm::inverse(obj->bones[i].anim.quat) * temp;
-				outVert.x = temp.x;
-				outVert.y = temp.y;
-				outVert.z = temp.z;
+				*outVert++ = inverse * (inVert.v - vector);
 			}
 		}
+		
+		arx_assert(outVert == eobj->vertexlocal + eobj->vertexlist.size());
 	}
 }
 
@@ -51,10 +51,12 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <sstream>
 #include <cstdio>
 #include <algorithm>
+#include <functional>
 #include <limits>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "ai/Paths.h"
 
@@ -101,7 +103,7 @@ long FORBID_SCRIPT_IO_CREATION = 0;
 SCR_TIMER * scr_timer = NULL;
 long ActiveTimers = 0;
 
-long FindScriptPos(const EERIE_SCRIPT * es, const std::string & str) {
+static long SearchScriptPos(const EERIE_SCRIPT * es, const std::string & str) {
 	
 	// TODO(script-parser) remove, respect quoted strings
 	
@@ -132,6 +134,19 @@ long FindScriptPos(const EERIE_SCRIPT * es, const std::string & str) {
 	return -1;
 }
 
+long FindScriptPos(const EERIE_SCRIPT * es, const std::string & str) {
+	
+	ScriptPositions::const_iterator it = es->positions.find(str);
+	if(it != es->positions.end()) {
+		return it->second;
+	}
+	
+	long pos = SearchScriptPos(es, str);
+	es->positions[str] = pos;
+	
+	return pos;
+}
+
 ScriptResult SendMsgToAllIO(ScriptMessage msg, const std::string & params) {
 	
 	ScriptResult ret = ACCEPT;
@@ -295,6 +310,8 @@ void ReleaseScript(EERIE_SCRIPT * es) {
 	
 	ARX_SCRIPT_ReleaseLabels(es);
 	memset(es->shortcut, 0, sizeof(long) * MAX_SHORTCUT);
+	es->compiled.clear();
+	es->positions.clear();
 }
 
 ValueType getSystemVar(const EERIE_SCRIPT * es, Entity * entity, const std::string & name,
@@ -1122,42 +1139,78 @@ void CloneLocalVars(Entity * ioo, Entity * io) {
 	ioo->script.lvar = io->script.lvar;
 }
 
-static SCRIPT_VAR * GetFreeVarSlot(SCRIPT_VARIABLES& _svff) {
-	_svff.resize(_svff.size() + 1);
-	SCRIPT_VAR * v = &_svff.back();
-	return v;
+void ScriptVariables::clear() {
+	m_variables.clear();
+	m_index.clear();
 }
 
-static SCRIPT_VAR * GetVarAddress(SCRIPT_VARIABLES & svf, const std::string & name) {
+SCRIPT_VAR * ScriptVariables::get(const std::string & name) {
 	
-	for(SCRIPT_VARIABLES::iterator it = svf.begin(); it != svf.end(); ++it) {
-		if(it->type != TYPE_UNKNOWN) {
-			if(name == it->name) {
-				return &(*it);
-			}
-		}
+	Index::const_iterator it = m_index.find(name);
+	if(it == m_index.end() || m_variables[it->second].type == TYPE_UNKNOWN) {
+		return NULL;
 	}
+	
+	return &m_variables[it->second];
+}
 
-	return NULL;
+const SCRIPT_VAR * ScriptVariables::get(const std::string & name) const {
+	
+	Index::const_iterator it = m_index.find(name);
+	if(it == m_index.end() || m_variables[it->second].type == TYPE_UNKNOWN) {
+		return NULL;
+	}
+	
+	return &m_variables[it->second];
 }
 
-static const SCRIPT_VAR * GetVarAddress(const SCRIPT_VARIABLES & svf,
-                                        const std::string & name) {
+SCRIPT_VAR & ScriptVariables::add(const std::string & name) {
 	
-	for(SCRIPT_VARIABLES::const_iterator it = svf.begin(); it != svf.end(); ++it) {
-		if(it->type != TYPE_UNKNOWN) {
-			if(name == it->name) {
-				return &(*it);
-			}
+	// Names are unique - never add a second variable that could be hidden or exposed by remove()
+	Index::const_iterator it = m_index.find(name);
+	if(it != m_index.end()) {
+		SCRIPT_VAR & var = m_variables[it->second];
+		if(var.type != TYPE_UNKNOWN) {
+			LogWarning << "Duplicate script variable " << name;
 		}
+		var = SCRIPT_VAR();
+		var.name = name;
+		return var;
 	}
+	
+	m_index[name] = m_variables.size();
+	
+	m_variables.resize(m_variables.size() + 1);
+	SCRIPT_VAR & var = m_variables.back();
+	var.name = name;
+	
+	return var;
+}
 
-	return NULL;
+bool ScriptVariables::remove(const std::string & name) {
+	
+	Index::iterator it = m_index.find(name);
+	if(it == m_index.end() || m_variables[it->second].type == TYPE_UNKNOWN) {
+		return false;
+	}
+	
+	size_t i = it->second;
+	m_variables.erase(m_variables.begin() + i);
+	m_index.erase(it);
+	
+	// Variables after the removed one have moved
+	for(Index::iterator j = m_index.begin(); j != m_index.end(); ++j) {
+		if(j->second > i) {
+			j->second--;
+		}
+	}
+	
+	return true;
 }
 
 long GETVarValueLong(const SCRIPT_VARIABLES& svf, const std::string & name) {
 	
-	const SCRIPT_VAR * tsv = GetVarAddress(svf, name);
+	const SCRIPT_VAR * tsv = svf.get(name);
 
 	if (tsv == NULL) return 0;
 
@@ -1166,7 +1219,7 @@ long GETVarValueLong(const SCRIPT_VARIABLES& svf, const std::string & name) {
 
 float GETVarValueFloat(const SCRIPT_VARIABLES& svf, const std::string & name) {
 	
-	const SCRIPT_VAR * tsv = GetVarAddress(svf, name);
+	const SCRIPT_VAR * tsv = svf.get(name);
 
 	if (tsv == NULL) return 0;
 
@@ -1175,7 +1228,7 @@ float GETVarValueFloat(const SCRIPT_VARIABLES& svf, const std::string & name) {
 
 std::string GETVarValueText(const SCRIPT_VARIABLES& svf, const std::string & name) {
 	
-	const SCRIPT_VAR* tsv = GetVarAddress(svf, name);
+	const SCRIPT_VAR* tsv = svf.get(name);
 
 	if (!tsv) return "";
 
@@ -1227,14 +1280,14 @@ std::string GetVarValueInterpretedAsText(const std::string & temp1, const EERIE_
 		else if (temp1[0] == '@') t1 = GETVarValueFloat(esss->lvar, temp1);
 		else if (temp1[0] == '$')
 		{
-			const SCRIPT_VAR * var = GetVarAddress(svar, temp1);
+			const SCRIPT_VAR * var = svar.get(temp1);
 
 			if (!var) return "void";
 			else return var->text;
 		}
 		else if (temp1[0] == '\xA3')
 		{
-			const SCRIPT_VAR * var = GetVarAddress(esss->lvar, temp1);
+			const SCRIPT_VAR * var = esss->lvar.get(temp1);
 
 			if (!var) return "void";
 			else return var->text;
@@ -1282,16 +1335,11 @@ float GetVarValueInterpretedAsFloat(const std::string & temp1, const EERIE_SCRIP
 
 SCRIPT_VAR* SETVarValueLong(SCRIPT_VARIABLES& svf, const std::string& name, long val)
 {
-	SCRIPT_VAR* tsv = GetVarAddress(svf, name);
+	SCRIPT_VAR* tsv = svf.get(name);
 
 	if (!tsv)
 	{
-		tsv = GetFreeVarSlot(svf);
-
-		if (!tsv)
-			return NULL;
-
-		tsv->name = name;
+		tsv = &svf.add(name);
 	}
 
 	tsv->ival = val;
@@ -1300,16 +1348,11 @@ SCRIPT_VAR* SETVarValueLong(SCRIPT_VARIABLES& svf, const std::string& name, long
 
 SCRIPT_VAR* SETVarValueFloat(SCRIPT_VARIABLES& svf, const std::string& name, float val)
 {
-	SCRIPT_VAR* tsv = GetVarAddress(svf, name);
+	SCRIPT_VAR* tsv = svf.get(name);
 
 	if (!tsv)
 	{
-		tsv = GetFreeVarSlot(svf);
-
-		if (!tsv)
-			return NULL;
-
-		tsv->name = name;
+		tsv = &svf.add(name);
 	}
 
 	tsv->fval = val;
@@ -1318,16 +1361,11 @@ SCRIPT_VAR* SETVarValueFloat(SCRIPT_VARIABLES& svf, const std::string& name, flo
 
 SCRIPT_VAR* SETVarValueText(SCRIPT_VARIABLES& svf, const std::string& name, const std::string& val)
 {
-	SCRIPT_VAR* tsv = GetVarAddress(svf, name);
+	SCRIPT_VAR* tsv = svf.get(name);
 
 	if (!tsv)
 	{
-		tsv = GetFreeVarSlot(svf);
-
-		if (!tsv)
-			return NULL;
-
-		tsv->name = name.c_str();
+		tsv = &svf.add(name);
 	}
 	
 	tsv->text = val;
@@ -1661,18 +1699,68 @@ ScriptResult SendInitScriptEvent(Entity * io) {
 	return ACCEPT;
 }
 
-//! Checks if timer named texx exists.
-static bool ARX_SCRIPT_Timer_Exist(const std::string & texx) {
+// Fire time and slot of running timers, as a min-heap
+// Entries are not removed when a timer is cleared or changed, so they are checked once they are due.
+typedef std::pair<unsigned long, long> ScheduledTimer;
+static std::vector<ScheduledTimer> g_timerQueue;
+
+typedef boost::unordered_multimap<std::string, long> TimersByName;
+typedef boost::unordered_multimap<Entity *, long> TimersByEntity;
+static TimersByName g_timersByName;
+static TimersByEntity g_timersByEntity;
+
+// All timer slots below this are in use
+static long g_firstFreeTimer = 0;
+
+static void ARX_SCRIPT_Timer_Schedule(long num) {
+	const SCR_TIMER & timer = scr_timer[num];
+	g_timerQueue.push_back(ScheduledTimer(timer.tim + timer.msecs, num));
+	std::push_heap(g_timerQueue.begin(), g_timerQueue.end(), std::greater<ScheduledTimer>());
+}
+
+void ARX_SCRIPT_Timer_Reschedule() {
+	
+	g_timerQueue.clear();
 	
 	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
 		if(scr_timer[i].exist) {
-			if(scr_timer[i].name == texx) {
-				return true;
-			}
+			g_timerQueue.push_back(ScheduledTimer(scr_timer[i].tim + scr_timer[i].msecs, i));
 		}
 	}
 	
-	return false;
+	std::make_heap(g_timerQueue.begin(), g_timerQueue.end(), std::greater<ScheduledTimer>());
+}
+
+void ARX_SCRIPT_Timer_Register(long num) {
+	
+	const SCR_TIMER & timer = scr_timer[num];
+	arx_assert(timer.exist);
+	
+	g_timersByName.insert(std::make_pair(timer.name, num));
+	g_timersByEntity.insert(std::make_pair(timer.io, num));
+	
+	if(g_timerQueue.size() > size_t(MAX_TIMER_SCRIPT) * 2) {
+		// Too many outdated entries
+		ARX_SCRIPT_Timer_Reschedule();
+	} else {
+		ARX_SCRIPT_Timer_Schedule(num);
+	}
+}
+
+template <typename Index>
+static void ARX_SCRIPT_Timer_Unindex(Index & index, const typename Index::key_type & key, long num) {
+	std::pair<typename Index::iterator, typename Index::iterator> range = index.equal_range(key);
+	for(typename Index::iterator it = range.first; it != range.second; ++it) {
+		if(it->second == num) {
+			index.erase(it);
+			return;
+		}
+	}
+}
+
+//! Checks if timer named texx exists.
+static bool ARX_SCRIPT_Timer_Exist(const std::string & texx) {
+	return g_timersByName.find(texx) != g_timersByName.end();
 }
 
 std::string ARX_SCRIPT_Timer_GetDefaultName() {
@@ -1693,9 +1781,11 @@ std::string ARX_SCRIPT_Timer_GetDefaultName() {
 //*************************************************************************************
 long ARX_SCRIPT_Timer_GetFree() {
 	
-	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-		if(!(scr_timer[i].exist))
+	for(long i = g_firstFreeTimer; i < MAX_TIMER_SCRIPT; i++) {
+		if(!(scr_timer[i].exist)) {
+			g_firstFreeTimer = i;
 			return i;
+		}
 	}
 	
 	return -1;
@@ -1715,6 +1805,9 @@ long ARX_SCRIPT_CountTimers() {
 void ARX_SCRIPT_Timer_ClearByNum(long timer_idx) {
 	if(scr_timer[timer_idx].exist) {
 		LogDebug("clearing timer " << scr_timer[timer_idx].name);
+		ARX_SCRIPT_Timer_Unindex(g_timersByName, scr_timer[timer_idx].name, timer_idx);
+		ARX_SCRIPT_Timer_Unindex(g_timersByEntity, scr_timer[timer_idx].io, timer_idx);
+		g_firstFreeTimer = std::min(g_firstFreeTimer, timer_idx);
 		scr_timer[timer_idx].name.clear();
 		ActiveTimers--;
 		scr_timer[timer_idx].exist = 0;
@@ -1722,21 +1815,28 @@ void ARX_SCRIPT_Timer_ClearByNum(long timer_idx) {
 }
 
 void ARX_SCRIPT_Timer_Clear_By_Name_And_IO(const std::string & timername, Entity * io) {
-	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-		if(scr_timer[i].exist && scr_timer[i].io == io && scr_timer[i].name == timername) {
-			ARX_SCRIPT_Timer_ClearByNum(i);
+	
+	for(;;) {
+		
+		long num = ARX_SCRIPT_GetSystemIOScript(io, timername);
+		if(num < 0) {
+			break;
 		}
+		
+		ARX_SCRIPT_Timer_ClearByNum(num);
 	}
 }
 
-void ARX_SCRIPT_Timer_Clear_All_Locals_For_IO(Entity * io)
-{
-	for (long i = 0; i < MAX_TIMER_SCRIPT; i++)
-	{
-		if (scr_timer[i].exist)
-		{
-			if ((scr_timer[i].io == io) && (scr_timer[i].es == &io->over_script))
-				ARX_SCRIPT_Timer_ClearByNum(i);
+void ARX_SCRIPT_Timer_Clear_All_Locals_For_IO(Entity * io) {
+	
+	std::pair<TimersByEntity::iterator, TimersByEntity::iterator> range;
+	range = g_timersByEntity.equal_range(io);
+	
+	for(TimersByEntity::iterator it = range.first; it != range.second; ) {
+		long num = it->second;
+		++it; // Clearing the timer removes it from the index
+		if(scr_timer[num].es == &io->over_script) {
+			ARX_SCRIPT_Timer_ClearByNum(num);
 		}
 	}
 }
@@ -1754,6 +1854,11 @@ void ARX_SCRIPT_Timer_FirstInit(long number)
 	delete[] scr_timer;
 	scr_timer = new SCR_TIMER[MAX_TIMER_SCRIPT];
 	ActiveTimers = 0;
+	
+	g_timerQueue.clear();
+	g_timersByName.clear();
+	g_timersByEntity.clear();
+	g_firstFreeTimer = 0;
 }
 
 void ARX_SCRIPT_Timer_ClearAll()
@@ -1763,27 +1868,33 @@ void ARX_SCRIPT_Timer_ClearAll()
 			ARX_SCRIPT_Timer_ClearByNum(i);
 
 	ActiveTimers = 0;
+	
+	g_timerQueue.clear();
 }
 
 void ARX_SCRIPT_Timer_Clear_For_IO(Entity * io) {
-	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-		if(scr_timer[i].exist && scr_timer[i].io == io) {
-			ARX_SCRIPT_Timer_ClearByNum(i);
+	for(;;) {
+		TimersByEntity::const_iterator it = g_timersByEntity.find(io);
+		if(it == g_timersByEntity.end()) {
+			break;
 		}
+		ARX_SCRIPT_Timer_ClearByNum(it->second);
 	}
 }
 
 long ARX_SCRIPT_GetSystemIOScript(Entity * io, const std::string & name) {
 	
-	if(ActiveTimers) {
-		for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-			if(scr_timer[i].exist && scr_timer[i].io == io && scr_timer[i].name == name) {
-				return i;
-			}
+	std::pair<TimersByEntity::const_iterator, TimersByEntity::const_iterator> range;
+	range = g_timersByEntity.equal_range(io);
+	
+	long num = -1;
+	for(TimersByEntity::const_iterator it = range.first; it != range.second; ++it) {
+		if(scr_timer[it->second].name == name && (num < 0 || it->second < num)) {
+			num = it->second;
 		}
 	}
 	
-	return -1;
+	return num;
 }
 
 static bool Manage_Specific_RAT_Timer(SCR_TIMER * st) {
@@ -1831,7 +1942,43 @@ void ARX_SCRIPT_Timer_Check() {
 		return;
 	}
 	
-	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
+	// Run due timers in slot order and check each slot at most once, like a scan over all slots
+	// would. Timers that are started by a timer event and are already due run in the same pass
+	// if their slot comes after the current one. Timers that fire every frame are scheduled again
+	// for the current time, so queue entries for slots that have already been checked are put
+	// aside and only restored for the next pass.
+	static std::vector<long> due; // Min-heap of slots
+	static std::vector<ScheduledTimer> checked;
+	due.clear();
+	checked.clear();
+	
+	long i = -1;
+	for(;;) {
+		
+		unsigned long queueTime = static_cast<unsigned long>(arxtime);
+		while(!g_timerQueue.empty() && g_timerQueue.front().first <= queueTime) {
+			const ScheduledTimer & entry = g_timerQueue.front();
+			if(entry.second > i) {
+				due.push_back(entry.second);
+				std::push_heap(due.begin(), due.end(), std::greater<long>());
+			} else {
+				checked.push_back(entry);
+			}
+			std::pop_heap(g_timerQueue.begin(), g_timerQueue.end(), std::greater<ScheduledTimer>());
+			g_timerQueue.pop_back();
+		}
+		
+		if(due.empty()) {
+			break;
+		}
+		
+		long slot = due.front();
+		std::pop_heap(due.begin(), due.end(), std::greater<long>());
+		due.pop_back();
+		if(slot <= i) {
+			continue; // Duplicate queue entry
+		}
+		i = slot;
 		
 		SCR_TIMER * st = &scr_timer[i];
 		if(!st->exist) {
@@ -1841,7 +1988,8 @@ void ARX_SCRIPT_Timer_Check() {
 		unsigned long now = static_cast<unsigned long>(arxtime);
 		unsigned long fire_time = st->tim + st->msecs;
 		if(fire_time > now) {
-			// Timer not ready to fire yet
+			// Timer not ready to fire yet - the queue entry was outdated
+			ARX_SCRIPT_Timer_Schedule(i);
 			continue;
 		}
 		
@@ -1851,6 +1999,7 @@ void ARX_SCRIPT_Timer_Check() {
 			st->tim += st->msecs * increment;
 			arx_assert(st->tim <= now && st->tim + st->msecs > now,
 			           "start=%lu wait=%ld now=%lu", st->tim, st->msecs, now);
+			ARX_SCRIPT_Timer_Schedule(i);
 			continue;
 		}
 		
@@ -1860,6 +2009,7 @@ void ARX_SCRIPT_Timer_Check() {
 		
 		if(!es && st->name == "_r_a_t_") {
 			if(Manage_Specific_RAT_Timer(st)) {
+				ARX_SCRIPT_Timer_Schedule(i);
 				continue;
 			}
 		}
@@ -1875,6 +2025,7 @@ void ARX_SCRIPT_Timer_Check() {
 				st->times--;
 			}
 			st->tim += st->msecs;
+			ARX_SCRIPT_Timer_Schedule(i);
 		}
 		
 		if(es && ValidIOAddress(io)) {
@@ -1885,6 +2036,11 @@ void ARX_SCRIPT_Timer_Check() {
 		}
 		
 	}
+	
+	for(size_t j = 0; j < checked.size(); j++) {
+		g_timerQueue.push_back(checked[j]);
+		std::push_heap(g_timerQueue.begin(), g_timerQueue.end(), std::greater<ScheduledTimer>());
+	}
 }
 
 void ARX_SCRIPT_Init_Event_Stats() {
@@ -2021,10 +2177,13 @@ void loadScript(EERIE_SCRIPT & script, PakFile * file) {
 	free(script.data);
 	
 	script.data = file->readAlloc();
-	script.size = file->size();
+	script.size = script.data ? file->size() : 0;
 	
 	std::transform(script.data, script.data + script.size, script.data, ::tolower);
 	
+	script.compiled.clear();
+	script.positions.clear();
+	
 	script.allowevents = 0;
 	
 	script.lvar.clear();
@@ -52,11 +52,15 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <string>
 #include <vector>
 
+#include <boost/unordered_map.hpp>
+
 #include "platform/Flags.h"
 
 class PakFile;
 class Entity;
 
+namespace script { class Command; }
+
 const size_t MAX_SHORTCUT = 80;
 const size_t MAX_SCRIPTTIMERS = 5;
 
@@ -108,7 +112,66 @@ enum DisabledEvent {
 DECLARE_FLAGS(DisabledEvent, DisabledEvents)
 DECLARE_FLAGS_OPERATORS(DisabledEvents)
 
-typedef std::vector<SCRIPT_VAR> SCRIPT_VARIABLES;
+/*!
+ * List of script variables with an index by name.
+ * Variables are kept in the order they were added, which is also the order they are saved in.
+ */
+class ScriptVariables {
+	
+	typedef std::vector<SCRIPT_VAR> Variables;
+	typedef boost::unordered_map<std::string, size_t> Index;
+	
+	Variables m_variables;
+	Index m_index;
+	
+public:
+	
+	typedef Variables::const_iterator const_iterator;
+	
+	size_t size() const { return m_variables.size(); }
+	bool empty() const { return m_variables.empty(); }
+	const SCRIPT_VAR & operator[](size_t i) const { return m_variables[i]; }
+	const_iterator begin() const { return m_variables.begin(); }
+	const_iterator end() const { return m_variables.end(); }
+	
+	void clear();
+	
+	/*!
+	 * Get the variable with the given name.
+	 * \return NULL if there is no such variable or its type has not been set.
+	 */
+	SCRIPT_VAR * get(const std::string & name);
+	const SCRIPT_VAR * get(const std::string & name) const;
+	
+	/*!
+	 * Add a new variable without a type.
+	 * Variable names are unique: if there is already a variable with the same name,
+	 * it is reset and returned instead.
+	 */
+	SCRIPT_VAR & add(const std::string & name);
+	
+	//! Remove the variable with the given name
+	bool remove(const std::string & name);
+	
+};
+
+typedef ScriptVariables SCRIPT_VARIABLES;
+
+/*!
+ * A command word that has been read from a script position and looked up.
+ * Script data does not change after loading, so this only needs to be done once per position.
+ */
+struct CompiledCommand {
+	size_t end; //!< Script position after the command word
+	std::string word; //!< The command word with underscores removed
+	script::Command * command; //!< The command for word or NULL if it is not a regular command
+};
+
+//! Compiled commands by their start position in the script
+typedef boost::unordered_map<size_t, CompiledCommand> CompiledCommands;
+
+//! Positions of event and label names in the script, -1 for names that were not found
+typedef boost::unordered_map<std::string, long> ScriptPositions;
 
 struct EERIE_SCRIPT {
 	size_t size;
@@ -121,6 +184,8 @@ struct EERIE_SCRIPT {
 	long shortcut[MAX_SHORTCUT];
 	long nb_labels;
 	LABEL_INFO * labels;
+	CompiledCommands compiled;
+	mutable ScriptPositions positions;
 
 	EERIE_SCRIPT() : size(), data(), lastcall(), allowevents(), master(), nb_labels(), labels() {
 		memset(&timers, 0, sizeof(timers));
@@ -428,6 +493,15 @@ void ARX_SCRIPT_Timer_FirstInit(long number);
 void ARX_SCRIPT_Timer_ClearAll();
 void ARX_SCRIPT_Timer_Clear_For_IO(Entity * io);
 long ARX_SCRIPT_Timer_GetFree();
+
+/*!
+ * Start a timer after its slot has been filled in.
+ * Must be called after setting exist for a new timer, or the timer will never run.
+ */
+void ARX_SCRIPT_Timer_Register(long num);
+
+//! Must be called after changing the start time or interval of running timers.
+void ARX_SCRIPT_Timer_Reschedule();
  
 void ARX_SCRIPT_SetMainEvent(Entity * io, const std::string & newevent);
 void ARX_SCRIPT_EventStackExecute(size_t limit = 20);
@@ -483,6 +557,8 @@ void Stack_SendIOScriptEvent(Entity * io, ScriptMessage msg, const std::string &
  * Finds the first occurence of str in the script that is followed
  * by a separator (a character of value less then or equal 32)
  * 
+ * The result is remembered, so searching for the same name again is a single lookup.
+ * 
  * \return The position of str in the script or -1 if str was not found.
  */
 long FindScriptPos(const EERIE_SCRIPT * es, const std::string & str);
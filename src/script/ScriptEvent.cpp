@@ -43,6 +43,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "script/ScriptEvent.h"
 
+#include <boost/unordered_map.hpp>
+
 #include "core/GameTime.h"
 #include "core/Core.h"
 
@@ -53,6 +55,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "io/log/Logger.h"
 
+#include "platform/profiler/Profiler.h"
+
 #include "script/ScriptUtils.h"
 #include "script/ScriptedAnimation.h"
 #include "script/ScriptedCamera.h"
@@ -250,6 +254,50 @@ static const char * toString(ScriptResult ret) {
 }
 #endif
 
+#if BUILD_PROFILER_INSTRUMENT
+
+// Profiler totals are looked up once per name, scripts only run on the main thread
+typedef boost::unordered_map<std::string, profiler::Totals *> ScriptTotals;
+static ScriptTotals g_entityTotals;
+static ScriptTotals g_eventTotals;
+static profiler::Totals * g_messageTotals[ARRAY_SIZE(AS_EVENT)];
+static boost::unordered_map<const script::Command *, profiler::Totals *> g_commandTotals;
+
+static profiler::Totals * getTotals(ScriptTotals & totals, const std::string & prefix,
+                                    const std::string & name) {
+	
+	profiler::Totals * & result = totals[name];
+	if(!result) {
+		result = profiler::getTotals(prefix + name);
+	}
+	
+	return result;
+}
+
+static profiler::Totals * getEntityTotals(const Entity * io) {
+	return getTotals(g_entityTotals, "script ", io ? io->className() : "unknown");
+}
+
+static profiler::Totals * getEventTotals(ScriptMessage msg, const std::string & evname) {
+	
+	if(!evname.empty() || size_t(msg) >= ARRAY_SIZE(AS_EVENT)) {
+		return getTotals(g_eventTotals, std::string(), ScriptEvent::getName(msg, evname));
+	}
+	
+	profiler::Totals * & result = g_messageTotals[msg];
+	if(!result) {
+		result = profiler::getTotals(ScriptEvent::getName(msg, evname));
+	}
+	
+	return result;
+}
+
+static profiler::Totals * getCommandTotals(const script::Command * command) {
+	return g_commandTotals[command];
+}
+
+#endif // BUILD_PROFILER_INSTRUMENT
+
 ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::string & params,
                                Entity * io, const std::string & evname, long info) {
 	
@@ -346,6 +394,9 @@ ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::
 		return ACCEPT;
 	}
 	
+	// Nested profile points for the entity class and the event
+	ARX_PROFILE_TOTALS(getEntityTotals(io));
+	ARX_PROFILE_TOTALS(getEventTotals(msg, evname));
 	
 	LogDebug("--> " << getName(msg, evname)
 	         << " params=\"" << params << "\""
@@ -375,9 +426,12 @@ ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::
 	
 	size_t brackets = 1;
 	
+	CompiledCommand uncached;
+	
 	for(;;) {
 		
-		std::string word = context.getCommand(msg != SM_EXECUTELINE);
+		const CompiledCommand & compiled = getCommand(context, msg != SM_EXECUTELINE, uncached);
+		const std::string & word = compiled.word;
 		if(word.empty()) {
 			if(msg == SM_EXECUTELINE && context.pos != es->size) {
 				arx_assert(es->data[context.pos] == '\n');
@@ -388,14 +442,9 @@ ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::
 			return ACCEPT;
 		}
 		
-		// Remove all underscores from the command.
-		word.resize(std::remove(word.begin(), word.end(), '_') - word.begin());
-		
-		Commands::const_iterator it = commands.find(word);
-		
-		if(it != commands.end()) {
+		if(compiled.command) {
 			
-			script::Command & command = *(it->second);
+			script::Command & command = *compiled.command;
 			
 			script::Command::Result res;
 			if(command.getEntityFlags()
@@ -406,7 +455,8 @@ ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::
 				context.skipCommand();
 				res = script::Command::Failed;
 			} else {
-				res = it->second->execute(context);
+				ARX_PROFILE_TOTALS(getCommandTotals(&command));
+				res = command.execute(context);
 			}
 			
 			if(res == script::Command::AbortAccept) {
@@ -463,6 +513,36 @@ ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::
 	return ret;
 }
 
+const CompiledCommand & ScriptEvent::getCommand(script::Context & context, bool skipNewlines,
+                                                CompiledCommand & uncached) {
+	
+	// Only cache commands read with newlines skipped - executeline is rare
+	CompiledCommands * cache = skipNewlines ? &context.getScript()->compiled : NULL;
+	
+	size_t start = context.pos;
+	if(cache) {
+		CompiledCommands::const_iterator it = cache->find(start);
+		if(it != cache->end()) {
+			context.pos = it->second.end;
+			return it->second;
+		}
+	}
+	
+	CompiledCommand & compiled = cache ? (*cache)[start] : uncached;
+	
+	compiled.word = context.getCommand(skipNewlines);
+	compiled.end = context.pos;
+	
+	// Remove all underscores from the command.
+	std::string & word = compiled.word;
+	word.resize(std::remove(word.begin(), word.end(), '_') - word.begin());
+	
+	Commands::const_iterator it = commands.find(word);
+	compiled.command = (it != commands.end()) ? it->second : NULL;
+	
+	return compiled;
+}
+
 void ScriptEvent::registerCommand(script::Command * command) {
 	
 	typedef std::pair<Commands::iterator, bool> Res;
@@ -472,8 +552,13 @@ void ScriptEvent::registerCommand(script::Command * command) {
 	if(!res.second) {
 		LogError << "Duplicate script command name: " + command->getName();
 		delete command;
+		return;
 	}
 	
+	#if BUILD_PROFILER_INSTRUMENT
+	g_commandTotals[command] = profiler::getTotals("command " + command->getName());
+	#endif
+	
 }
 
 void ScriptEvent::init() {
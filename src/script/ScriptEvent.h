@@ -35,6 +35,7 @@ namespace script {
 std::string loadUnlocalized(const std::string & str);
 
 class Command;
+class Context;
 
 } // namespace script
 
@@ -60,6 +61,13 @@ private:
 	typedef std::map<std::string, script::Command *> Commands;
 	static Commands commands;
 	
+	/*!
+	 * Read the next command word and look up the corresponding command.
+	 * Results are cached in the script, so each position is only parsed once.
+	 */
+	static const CompiledCommand & getCommand(script::Context & context, bool skipNewlines,
+	                                          CompiledCommand & uncached);
+	
 };
 
 #endif // ARX_SCRIPT_SCRIPTEVENT_H
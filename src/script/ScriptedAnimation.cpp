@@ -292,6 +292,7 @@ public:
 			scr_timer[num2].tim = (unsigned long)(arxtime);
 			scr_timer[num2].times = 1;
 			scr_timer[num2].longinfo = 0;
+			ARX_SCRIPT_Timer_Register(num2);
 			
 			DebugScript(": scheduled timer #" << num2 << ' ' << timername << " in "
 			            << scr_timer[num2].msecs << "ms");
@@ -897,6 +897,8 @@ void timerCommand(const std::string & timer, Context & context) {
 	
 	scr_timer[num].flags = (idle && io) ? 1 : 0;
 	
+	ARX_SCRIPT_Timer_Register(num);
+	
 }
 
 void setupScriptedLang() {
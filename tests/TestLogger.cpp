@@ -0,0 +1,39 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * \file
+ *
+ * Minimal logger implementation for the tests.
+ * The full logger has too many dependencies - errors are written to stderr instead.
+ */
+
+#include <iostream>
+
+#include "io/log/Logger.h"
+
+bool Logger::isEnabled(const char * file, LogLevel level) {
+	ARX_UNUSED(file);
+	return level >= Warning && level != None;
+}
+
+void Logger::log(const char * file, int line, LogLevel level, const std::string & str) {
+	ARX_UNUSED(level);
+	std::cerr << file << ':' << line << ": " << str << std::endl;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathClustersTest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <cppunit/TestAssert.h>
+
+#include "ai/PathClusters.h"
+#include "physics/Anchors.h"
+
+namespace {
+
+/*!
+ * A winding chain of anchors, one per cluster, with a dead end branch.
+ * Positions are not integers so that the cluster distances do not add up exactly.
+ */
+class AnchorChain {
+	
+	std::vector<ANCHOR_DATA> m_anchors;
+	std::vector<std::vector<long> > m_links;
+	
+public:
+	
+	static const size_t length = 40;
+	
+	explicit AnchorChain(float linkRadius) : m_anchors(length + 1), m_links(length + 1) {
+		
+		for(size_t i = 0; i < length; i++) {
+			ANCHOR_DATA & anchor = m_anchors[i];
+			float offset = 0.1f * float(i % 7) + 0.337f;
+			anchor.pos = Vec3f(1000.f * float(i % 8) + 333.3f + offset, 17.17f * offset,
+			                   1000.f * float(i / 8) + 666.7f - offset);
+			if(i > 0) {
+				link(i - 1, i);
+			}
+		}
+		
+		// Dead end next to the middle of the chain
+		m_anchors[length].pos = m_anchors[length / 2].pos + Vec3f(0.3f, 600.7f, 0.f);
+		link(length / 2, length);
+		
+		for(size_t i = 0; i < m_anchors.size(); i++) {
+			ANCHOR_DATA & anchor = m_anchors[i];
+			anchor.flags = AnchorFlags();
+			anchor.radius = linkRadius;
+			anchor.height = -160.f;
+			anchor.nblinked = short(m_links[i].size());
+			anchor.linked = &m_links[i][0];
+		}
+	}
+	
+	void link(size_t a, size_t b) {
+		m_links[a].push_back(long(b));
+		m_links[b].push_back(long(a));
+	}
+	
+	size_t size() const { return m_anchors.size(); }
+	const ANCHOR_DATA * data() const { return &m_anchors[0]; }
+	
+};
+
+} // anonymous namespace
+
+void PathClustersTest::corridorTest() {
+	
+	AnchorChain chain(40.f);
+	PathClusters clusters(chain.size(), chain.data());
+	CPPUNIT_ASSERT_EQUAL(chain.size(), clusters.getClusterCount());
+	
+	for(size_t from = 0; from < AnchorChain::length; from += 3) {
+		for(size_t to = 0; to < AnchorChain::length; to++) {
+			
+			std::vector<bool> corridor;
+			CPPUNIT_ASSERT(clusters.findCorridor(from, to, 30.f, -160.f, corridor));
+			CPPUNIT_ASSERT_EQUAL(clusters.getClusterCount(), corridor.size());
+			
+			// Every cluster between the two anchors is on the route
+			for(size_t i = std::min(from, to); i <= std::max(from, to); i++) {
+				CPPUNIT_ASSERT(corridor[clusters.getCluster(i)]);
+			}
+		}
+	}
+}
+
+void PathClustersTest::blockedTest() {
+	
+	AnchorChain chain(20.f);
+	PathClusters clusters(chain.size(), chain.data());
+	
+	std::vector<bool> corridor;
+	CPPUNIT_ASSERT(!clusters.findCorridor(0, AnchorChain::length - 1, 30.f, -160.f, corridor));
+	CPPUNIT_ASSERT(clusters.findCorridor(0, AnchorChain::length - 1, 20.f, -160.f, corridor));
+}
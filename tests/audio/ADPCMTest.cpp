@@ -0,0 +1,190 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ADPCMTest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <cppunit/TestAssert.h>
+
+#include "audio/codec/ADPCM.h"
+#include "audio/codec/WAVFormat.h"
+#include "io/resource/PakReader.h"
+
+namespace {
+
+class MemoryFileHandle : public PakFileHandle {
+	
+	const std::vector<u8> & m_data;
+	size_t m_pos;
+	
+public:
+	
+	explicit MemoryFileHandle(const std::vector<u8> & data) : m_data(data), m_pos(0) { }
+	
+	size_t read(void * buf, size_t size) {
+		size = std::min(size, m_data.size() - m_pos);
+		if(size) {
+			memcpy(buf, &m_data[m_pos], size);
+		}
+		m_pos += size;
+		return size;
+	}
+	
+	int seek(Whence whence, int offset) {
+		switch(whence) {
+			case SeekSet: m_pos = offset; break;
+			case SeekCur: m_pos += offset; break;
+			case SeekEnd: m_pos = m_data.size() + offset; break;
+		}
+		m_pos = std::min(m_pos, m_data.size());
+		return int(m_pos);
+	}
+	
+	size_t tell() {
+		return m_pos;
+	}
+	
+};
+
+struct TestChannel {
+	s16 delta;
+	s16 samp1;
+	s16 samp2;
+	s16 coef1;
+	s16 coef2;
+};
+
+// Straightforward one sample at a time decoder to compare against
+s16 referenceSample(TestChannel & c, u8 nybble) {
+	
+	static const short adaption[] = {
+		230, 230, 230, 230, 307, 409, 512, 614,
+		768, 614, 512, 409, 307, 230, 230, 230
+	};
+	
+	s32 old_delta = c.delta;
+	c.delta = std::max(s16((adaption[nybble] * old_delta) >> 8), s16(16));
+	
+	s32 sample = (nybble & 0x08) ? nybble - 16 : nybble;
+	s32 predict = (s32(c.samp1) * c.coef1 + s32(c.samp2) * c.coef2) >> 8;
+	s32 pcm = std::min(std::max(sample * old_delta + predict, s32(-32768)), s32(32767));
+	
+	c.samp2 = c.samp1;
+	c.samp1 = s16(pcm);
+	
+	return c.samp1;
+}
+
+const s16 coefficients[7][2] = {
+	{ 256, 0 }, { 512, -256 }, { 0, 0 }, { 192, 64 }, { 240, 0 }, { 460, -208 }, { 392, -232 }
+};
+
+void testDecoder(size_t channels, size_t samplesPerBlock, size_t blocks) {
+	
+	std::vector<u8> headerData(sizeof(ADPCMHeader) + 6 * sizeof(ADPCMCoefficientPair));
+	ADPCMHeader & header = *reinterpret_cast<ADPCMHeader *>(&headerData[0]);
+	size_t nybbles = (samplesPerBlock - 2) * channels / 2;
+	header.wfx.channels = u16(channels);
+	header.wfx.bitsPerSample = 4;
+	header.wfx.blockAlign = u16(7 * channels + nybbles);
+	header.samplesPerBlock = u16(samplesPerBlock);
+	header.coefficientCount = 7;
+	for(size_t i = 0; i < 7; i++) {
+		header.coefficients[i].coef1 = coefficients[i][0];
+		header.coefficients[i].coef2 = coefficients[i][1];
+	}
+	
+	// Generate random blocks and decode them with the reference decoder
+	std::vector<u8> data;
+	std::vector<s16> expected;
+	u32 seed = 12345;
+	for(size_t block = 0; block < blocks; block++) {
+		
+		TestChannel c[2];
+		size_t start = data.size();
+		data.resize(start + header.wfx.blockAlign);
+		for(size_t i = 7 * channels; i < header.wfx.blockAlign; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[start + i] = u8(seed >> 16);
+		}
+		
+		for(size_t i = 0; i < channels; i++) {
+			u8 predictor = u8((block + i) % 7);
+			data[start + i] = predictor;
+			c[i].coef1 = coefficients[predictor][0];
+			c[i].coef2 = coefficients[predictor][1];
+			c[i].delta = s16(16 + block * 100 + i);
+			c[i].samp1 = s16(block * 1000 - i * 7);
+			c[i].samp2 = s16(-s32(block) * 500 + s32(i));
+			memcpy(&data[start + channels + 2 * i], &c[i].delta, 2);
+			memcpy(&data[start + channels * 3 + 2 * i], &c[i].samp1, 2);
+			memcpy(&data[start + channels * 5 + 2 * i], &c[i].samp2, 2);
+		}
+		
+		// The first sample of the stream is skipped
+		for(size_t i = 0; i < channels && block != 0; i++) {
+			expected.push_back(c[i].samp2);
+		}
+		for(size_t i = 0; i < channels; i++) {
+			expected.push_back(c[i].samp1);
+		}
+		
+		const u8 * nybble = &data[start + 7 * channels];
+		for(size_t i = 0; i < (samplesPerBlock - 2) * channels; i++) {
+			u8 byte = nybble[i / 2];
+			expected.push_back(referenceSample(c[i % channels], (i % 2) ? (byte & 0x0f) : (byte >> 4)));
+		}
+	}
+	
+	// Read the stream in chunks of different sizes, including odd ones
+	const size_t chunkSizes[] = { 1, 3, 4096, 2 * samplesPerBlock * channels, 7 };
+	for(size_t i = 0; i < ARRAY_SIZE(chunkSizes); i++) {
+		
+		MemoryFileHandle file(data);
+		audio::CodecADPCM codec;
+		codec.setStream(&file);
+		CPPUNIT_ASSERT_EQUAL(audio::AAL_OK, codec.setHeader(&header));
+		
+		std::vector<u8> output(expected.size() * sizeof(s16));
+		size_t pos = 0;
+		while(pos < output.size()) {
+			size_t size = std::min(chunkSizes[i], output.size() - pos);
+			size_t read;
+			CPPUNIT_ASSERT_EQUAL(audio::AAL_OK, codec.read(&output[pos], size, read));
+			CPPUNIT_ASSERT_EQUAL(size, read);
+			pos += read;
+		}
+		
+		CPPUNIT_ASSERT(memcmp(&output[0], &expected[0], output.size()) == 0);
+	}
+	
+}
+
+} // anonymous namespace
+
+void ADPCMTest::monoTest() {
+	testDecoder(1, 1012, 5);
+}
+
+void ADPCMTest::stereoTest() {
+	testDecoder(2, 500, 5);
+}
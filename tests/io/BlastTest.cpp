@@ -0,0 +1,163 @@
+/*
+ * Copyright 2015 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tests/io/BlastTest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <cppunit/TestAssert.h>
+
+#include "io/Blast.h"
+#include "platform/Platform.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BlastTest);
+
+namespace {
+
+// 13073 bytes of literals and matches, Huffman-coded literals, 4096 byte dictionary
+const unsigned char codedLiterals[] = {
+	0x01, 0x06, 0x3e, 0xc0, 0x7f, 0xc0, 0x61, 0x3a, 0x32, 0x40, 0xb6, 0xf0, 0x33, 0x02, 0xfc, 0xfd,
+	0x9d, 0xe4, 0x30, 0x02, 0x52, 0xf2, 0xcd, 0x60, 0x30, 0x03, 0xf2, 0x35, 0x25, 0xa0, 0xdc, 0x8f,
+	0x41, 0x0f, 0xc8, 0x8b, 0xa2, 0x03, 0x80, 0x02, 0xd4, 0x0c, 0xc7, 0x71, 0x80, 0x3a, 0xf0, 0x0b,
+	0xfa, 0x34, 0x06, 0x58, 0xd0, 0x80, 0x2a, 0x80, 0x2f, 0x3b, 0xcc, 0xa0, 0x10, 0x29, 0x80, 0xb3,
+	0x85, 0x42, 0xd8, 0x68, 0x30, 0x03, 0x20, 0x01, 0x28, 0x13, 0x9a, 0x18, 0x08, 0x25, 0xc2, 0x4e,
+	0xb3, 0x43, 0x06, 0xc3, 0x01, 0x48, 0x00, 0x86, 0x25, 0x10, 0x36, 0x84, 0x19, 0xfc, 0x17, 0x19,
+	0x0c, 0x06, 0x2d, 0x80, 0x84, 0x64, 0x07, 0x90, 0x28, 0x3c, 0xe0, 0xa3, 0x31, 0xc8, 0x01, 0x24,
+	0x20, 0x2a, 0x83, 0x11, 0x84, 0xd4, 0x20, 0x90, 0x4a, 0x9d, 0x98, 0x61, 0x63, 0x1a, 0x0c, 0xcc,
+	0x00, 0x12, 0xc5, 0x06, 0x52, 0xc1, 0x86, 0x9a, 0x1c, 0xd4, 0x04, 0x36, 0xc0, 0x73, 0xf9, 0x04,
+	0xa4, 0x4a, 0x6f, 0x42, 0xb2, 0x80, 0x14, 0x93, 0x19, 0x12, 0xf9, 0x0b, 0x40, 0xc1, 0xff, 0x3e,
+	0xc0, 0xdf, 0x80, 0x02, 0xb4, 0x51, 0x62, 0x00, 0x0d, 0xef, 0x0b, 0x9b, 0xcd, 0x01, 0xd8, 0x00,
+	0x75, 0xd8, 0x18, 0x5d, 0x10, 0x63, 0x5c, 0x01, 0x95, 0x2e, 0x14, 0x34, 0x0a, 0x06, 0x2a, 0x4e,
+	0x40, 0x92, 0x7b, 0x3b, 0xcc, 0x00, 0x13, 0x4d, 0x01, 0xce, 0x0c, 0x06, 0x40, 0x0f, 0x74, 0x03,
+	0xfc, 0x21, 0x06, 0x06, 0x80, 0x1d, 0x40, 0x52, 0x5a, 0x6b, 0x41, 0x40, 0x05, 0xac, 0x2e, 0x0d,
+	0x72, 0xe0, 0x86, 0x13, 0xe0, 0xcf, 0x9e, 0x01, 0x1e, 0x50, 0x30, 0x03, 0x95, 0x04, 0x3d, 0xc8,
+	0x89, 0x09, 0x23, 0x80, 0x44, 0x48, 0x2e, 0x40, 0xcc, 0xd0, 0xb0, 0x49, 0x26, 0x54, 0x06, 0x08,
+	0x02, 0xba, 0x00, 0x5d, 0x4d, 0x31, 0x03, 0x38, 0xf5, 0x03, 0x48, 0x39, 0x0e, 0x33, 0x41, 0xf5,
+	0x03, 0x86, 0x45, 0x10, 0x2c, 0x66, 0x58, 0xf4, 0x03, 0x60, 0x64, 0x04, 0xe0, 0x40, 0xf4, 0x00,
+	0x71, 0x80, 0x3f, 0x9a, 0x0e, 0xf8, 0x07,
+};
+
+// 10177 bytes of literals and matches, uncoded literals, 1024 byte dictionary
+const unsigned char uncodedLiterals[] = {
+	0x00, 0x04, 0xc2, 0x7a, 0xd8, 0xc6, 0x58, 0x80, 0xdd, 0x28, 0xcc, 0x28, 0x2a, 0x0c, 0x41, 0x4e,
+	0x3b, 0xe4, 0xc4, 0x90, 0x07, 0x48, 0x4b, 0xef, 0x9f, 0x18, 0xf6, 0x80, 0x66, 0x86, 0x18, 0x33,
+	0x16, 0x60, 0x43, 0x6c, 0x63, 0xc6, 0xa8, 0x31, 0x41, 0xc0, 0x26, 0x20, 0x82, 0x05, 0xc6, 0x12,
+	0xfe, 0x0a, 0x4b, 0x64, 0x08, 0x4f, 0x1c, 0x82, 0x81, 0xb6, 0x27, 0x21, 0x9b, 0x9c, 0xb0, 0x81,
+	0x99, 0x30, 0x63, 0xe6, 0x82, 0x62, 0x0e, 0x61, 0xc4, 0xb8, 0x06, 0x9c, 0x16, 0x19, 0x6b, 0xb1,
+	0xc3, 0xca, 0xc8, 0xb0, 0x39, 0x64, 0x0c, 0x76, 0x20, 0x25, 0xe1, 0x99, 0x9d, 0x30, 0x2f, 0xa0,
+	0x1a, 0x34, 0x02, 0xa7, 0x5c, 0xa7, 0xc0, 0x5a, 0x98, 0x04, 0x63, 0x01, 0x77, 0x84, 0x0b, 0x86,
+	0xe6, 0x45, 0x02, 0xe3, 0x00, 0x6a, 0xae, 0x0a, 0x3b, 0x1b, 0xfc, 0x06, 0x39, 0xd8, 0xe4, 0x13,
+	0xa0, 0xc8, 0x11, 0xf0, 0xc4, 0x02, 0x15, 0x88, 0x0f, 0x18, 0x87, 0x52, 0x62, 0x61, 0x83, 0x5c,
+	0x61, 0xc2, 0x1a, 0xaa, 0x8c, 0x09, 0x83, 0x2a, 0x2c, 0x60, 0xd5, 0xa2, 0xb0, 0x89, 0x0b, 0xcf,
+	0x98, 0x07, 0x5c, 0x61, 0x83, 0xe9, 0x00, 0x50, 0xe0, 0x0b, 0x36, 0x6c, 0x36, 0x2c, 0x2c, 0xe0,
+	0x5a, 0xb8, 0xdc, 0x84, 0x31, 0x0b, 0xf4, 0x01, 0x2e, 0x6f, 0x61, 0x4a, 0x42, 0x1d, 0x30, 0x88,
+	0x85, 0xcd, 0x19, 0xcf, 0x81, 0x84, 0xe0, 0x01, 0xfe, 0xa4, 0x0d, 0xf0, 0x7f, 0x02, 0x02, 0xc1,
+	0x35, 0x00, 0x5f, 0x0d, 0x62, 0x01, 0x31, 0xd8, 0x0d, 0xf8, 0x07,
+};
+
+struct TestInput {
+	const unsigned char * data;
+	size_t size;
+	size_t chunkSize;
+};
+
+// Hand out the input in small pieces to also test resuming in the middle of an input buffer
+size_t testIn(void * how, const unsigned char ** buf) {
+	TestInput * in = static_cast<TestInput *>(how);
+	size_t size = std::min(in->size, in->chunkSize);
+	*buf = in->data;
+	in->data += size;
+	in->size -= size;
+	return size;
+}
+
+int testOut(void * how, unsigned char * buf, size_t len) {
+	std::vector<unsigned char> * out = static_cast<std::vector<unsigned char> *>(how);
+	out->insert(out->end(), buf, buf + len);
+	return 0;
+}
+
+void testCheckpoint(void * how, const BlastCheckpoint & checkpoint) {
+	static_cast<std::vector<BlastCheckpoint> *>(how)->push_back(checkpoint);
+}
+
+void decode(const unsigned char * data, size_t size, size_t chunkSize,
+            const BlastCheckpoint * resume, std::vector<unsigned char> & out,
+            std::vector<BlastCheckpoint> & checkpoints) {
+	
+	size_t offset = resume ? resume->inOffset : 0;
+	CPPUNIT_ASSERT(offset <= size);
+	
+	TestInput in = { data + offset, size - offset, chunkSize };
+	BlastResult result = blast(testIn, &in, testOut, &out, resume, testCheckpoint, &checkpoints);
+	CPPUNIT_ASSERT_EQUAL(BLAST_SUCCESS, result);
+}
+
+void resumeTest(const unsigned char * data, size_t size, size_t expectedSize) {
+	
+	// Single-shot decode
+	std::vector<unsigned char> reference;
+	std::vector<BlastCheckpoint> checkpoints;
+	decode(data, size, size, NULL, reference, checkpoints);
+	CPPUNIT_ASSERT_EQUAL(expectedSize, reference.size());
+	CPPUNIT_ASSERT_EQUAL(expectedSize / BLAST_WINDOW_SIZE, checkpoints.size());
+	
+	// Checkpoints must not depend on how the input is split
+	std::vector<unsigned char> out;
+	std::vector<BlastCheckpoint> split;
+	decode(data, size, 7, NULL, out, split);
+	CPPUNIT_ASSERT(out == reference);
+	CPPUNIT_ASSERT_EQUAL(checkpoints.size(), split.size());
+	
+	for(size_t i = 0; i < checkpoints.size(); i++) {
+		
+		const BlastCheckpoint & checkpoint = checkpoints[i];
+		CPPUNIT_ASSERT_EQUAL(split[i].inOffset, checkpoint.inOffset);
+		CPPUNIT_ASSERT_EQUAL((i + 1) * BLAST_WINDOW_SIZE, checkpoint.outOffset);
+		
+		// Resuming must produce exactly the remaining output of the single-shot decode
+		std::vector<unsigned char> rest;
+		std::vector<BlastCheckpoint> later;
+		decode(data, size, 5, &checkpoint, rest, later);
+		
+		CPPUNIT_ASSERT_EQUAL(reference.size() - checkpoint.outOffset, rest.size());
+		CPPUNIT_ASSERT(std::equal(rest.begin(), rest.end(), reference.begin() + checkpoint.outOffset));
+		
+		// Resumed decompression must record the same later checkpoints
+		CPPUNIT_ASSERT_EQUAL(checkpoints.size() - i - 1, later.size());
+		for(size_t j = 0; j < later.size(); j++) {
+			const BlastCheckpoint & expected = checkpoints[i + 1 + j];
+			CPPUNIT_ASSERT_EQUAL(expected.inOffset, later[j].inOffset);
+			CPPUNIT_ASSERT_EQUAL(expected.outOffset, later[j].outOffset);
+			CPPUNIT_ASSERT(!memcmp(expected.window, later[j].window, BLAST_WINDOW_SIZE));
+		}
+	}
+}
+
+} // anonymous namespace
+
+void BlastTest::codedLiteralsTest() {
+	resumeTest(codedLiterals, ARRAY_SIZE(codedLiterals), 13073);
+}
+
+void BlastTest::uncodedLiteralsTest() {
+	resumeTest(uncodedLiterals, ARRAY_SIZE(uncodedLiterals), 10177);
+}
@@ -22,7 +22,10 @@
 #include <cppunit/TestResultCollector.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "ai/PathClustersTest.h"
+#include "audio/ADPCMTest.h"
 #include "graphics/ColorTest.h"
+#include "io/BlastTest.h"
 #include "io/IniTest.h"
 #include "math/LegacyMathTest.h"
 
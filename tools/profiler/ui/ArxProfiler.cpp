@@ -27,7 +27,9 @@
 #include <QHash>
 
 #include <QClipboard>
+#include <QDockWidget>
 #include <QFileDialog>
+#include <QTreeWidget>
 
 #include <QMouseEvent>
 #include <QWheelEvent>
@@ -52,6 +54,16 @@ ArxProfiler::ArxProfiler(QWidget *parent, Qt::WindowFlags flags)
 
 	view = new ProfilerView(this);
 	setCentralWidget(view);
+	
+	totalsView = new QTreeWidget(this);
+	totalsView->setColumnCount(4);
+	totalsView->setHeaderLabels(QStringList() << "Tag" << "Count" << "Total (us)" << "Average (us)");
+	totalsView->setRootIsDecorated(false);
+	totalsView->setSortingEnabled(true);
+	
+	QDockWidget * totalsDock = new QDockWidget(tr("Totals"), this);
+	totalsDock->setWidget(totalsView);
+	addDockWidget(Qt::BottomDockWidgetArea, totalsDock);
 
 	connect(ui->action_Open, SIGNAL(triggered()), this, SLOT(openFile()));
 }
@@ -77,6 +89,7 @@ void ArxProfiler::openFile() {
 	
 	m_threads.clear();
 	m_strings.clear();
+	totalsView->clear();
 	
 	QByteArray fileData = file.readAll();
 	int filePos = 0;
@@ -154,8 +167,24 @@ void ArxProfiler::openFile() {
 				m_threads[sample.threadId].profilePoints.push_back(sample);
 			}
 		}
+		
+		if(chunk.type == ArxProfilerChunkType_Totals) {
+			int pos = 0;
+			while(pos < chunkData.size()) {
+				SavedProfilerTotals saved;
+				readStruct(saved, chunkData, pos);
+				
+				QTreeWidgetItem * item = new QTreeWidgetItem(totalsView);
+				item->setText(0, m_strings.at(saved.stringIndex));
+				item->setData(1, Qt::DisplayRole, quint64(saved.count));
+				item->setData(2, Qt::DisplayRole, quint64(saved.time));
+				item->setData(3, Qt::DisplayRole, quint64(saved.count ? saved.time / saved.count : 0));
+			}
+		}
 	}
 	
+	totalsView->sortByColumn(2, Qt::DescendingOrder);
+	
 	view->setData(&m_threads);
 }
 
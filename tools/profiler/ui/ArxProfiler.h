@@ -25,6 +25,8 @@
 
 #include <map>
 
+class QTreeWidget;
+
 struct ProfileSample {
 	QString tag;
 	quint64 threadId;
@@ -99,6 +101,7 @@ private slots:
 private:
 	Ui::ArxProfilerClass * ui;
 	ProfilerView * view;
+	QTreeWidget * totalsView;
 	
 	QStringList m_strings;
 	ThreadsData m_threads;